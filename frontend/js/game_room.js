@@ -4,22 +4,42 @@
  * WebSocket protocol (as implemented by the backend):
  *   - First message after connect MUST be the auth frame: {token, game_id}.
  *   - Then action frames: {action: "state" | "place" | "submit" | "pass" | "change", ...}.
+ *   - What never changes during a game comes once, before the first full state
+ *     of the connection and before the full state of a resync:
+ *       {
+ *         setup: {
+ *           variant: "standard" | "super" | "quick", width, height,
+ *           prices:  prices[x][y]   (-1 == plain cell, 2/3 == letter x2/x3,
+ *                                    20/30 == word x2/x3),
+ *           alphabet: [<char>, ...], values: [<int>, ...],
+ *           players: [<id>, ...]
+ *         }
+ *       }
  *   - Server replies are either  {error: "..."}  or a full state snapshot:
  *       {
  *         public: {
- *           current_player: <index into players>,
+ *           current_player: <index into setup.players>,
  *           bag_size: <int>,
- *           players: [{id, score}, ...],
- *           letters: letters[x][y]  (" " == empty),
- *           prices:  prices[x][y]   (-1 == plain cell)
+ *           scores: [<int>, ...],   // by index into setup.players
+ *           letters: letters[x][y]  (" " == empty)
  *         },
  *         private: {
  *           hand: [<char>, ...],
  *           pending_score: <int>    // present ONLY when it is THIS player's turn
  *         }
  *       }
- *   - A successful place/submit/pass/change broadcasts a fresh state to every
+ *     Every state has a `version`. A `state` action may carry the version we
+ *     hold; if the server can, it answers with a delta instead:
+ *       {
+ *         base: <version it applies to>, version: <int>,
+ *         public: {cells: [[x, y, letter], ...], scores: [[index, score], ...],
+ *                  current_player, bag_size},   // only what changed
+ *         private: {hand, pending_score}        // hand only if changed,
+ *       }                                       // no private == not our turn
+ *   - A successful place/submit/pass/change broadcasts a delta to every
  *     connected player, so opponent moves arrive as pushes (we also poll lightly).
+ *     A delta whose base is not our version means we missed one: we ask for the
+ *     full state again.
  *   - `place` does NOT put tiles on the board; it only (re)computes pending_score
  *     for the full set of pending tiles sent each time. Tiles land on the board
  *     only on `submit`. So we keep a local pending overlay until then.
@@ -32,6 +52,7 @@ const token = localStorage.getItem("auth_token");
 let ws = null;
 let gameId = null;
 
+let setup = null;            // static layout of the game, see the setup message
 let lastState = null;        // last full state snapshot from the server
 let started = false;         // game is ongoing (past the lobby)
 let myTurn = false;          // derived from presence of private.pending_score
@@ -98,7 +119,12 @@ function sendWS(obj) {
     ws.send(JSON.stringify(obj));
 }
 
-function requestState() { dbg("poll: request state"); sendWS({ action: "state" }); }
+function requestState() {
+    dbg("poll: request state");
+    if (lastState) sendWS({ action: "state", version: lastState.version });
+    else sendWS({ action: "state" });
+}
+function requestFullState() { dbg("resync: request full state"); sendWS({ action: "state" }); }
 
 // ---------------------------------------------------------------- init
 function initGameRoom() {
@@ -159,11 +185,15 @@ function stopPolling() { if (pollTimer) { clearInterval(pollTimer); pollTimer =
 //
 // Server frames (current protocol):
 //   {error: "..."}                                  -> error
+//   {setup: {...}}                                  -> layout, a full state follows
 //   {ongoing: false}                                -> game not started (lobby)
 //   {ongoing: true, public: {...}, private: {...}}  -> full state snapshot
+//   {base: N, ongoing: true, public: {...}, ...}    -> delta from version N
 function handleMessage(msg) {
     if (msg.error !== undefined) { dbg("route → error"); handleError(msg.error); return; }
+    if (msg.setup !== undefined) { dbg("route → setup (" + msg.setup.variant + ")"); onSetup(msg.setup); return; }
     if (msg.ongoing === false) { dbg("route → lobby (ongoing=false)"); onLobby(); return; }
+    if (msg.base !== undefined) { dbg("route → delta (base=" + msg.base + ")"); onDelta(msg); return; }
     if (msg.ongoing === true && msg.public) { dbg("route → state (ongoing=true)"); onState(msg); return; }
     dbg("route → UNHANDLED frame", msg);
 }
@@ -197,6 +227,39 @@ function handleError(err) {
     qs("pendingScore").textContent = "неверно";
 }
 
+// The board is as big as the variant of the game says.
+function onSetup(msg) {
+    setup = msg;
+    if (qs("gameBoard").children.length !== setup.width * setup.height) buildEmptyBoard(setup.width);
+}
+
+// Applies a delta to lastState and renders the result as a full state.
+function onDelta(msg) {
+    if (lastState && msg.version <= lastState.version && msg.base !== lastState.version) {
+        dbg("DELTA: stale, ignored");
+        return;
+    }
+    if (!lastState || lastState.version !== msg.base) {
+        dbg("DELTA: version gap", { have: lastState && lastState.version, base: msg.base });
+        requestFullState();
+        return;
+    }
+    const state = structuredClone(lastState);
+    const pub = msg.public;
+    for (const [x, y, letter] of pub.cells || []) state.public.letters[x][y] = letter;
+    for (const [index, score] of pub.scores || []) state.public.scores[index] = score;
+    if (pub.current_player !== undefined) state.public.current_player = pub.current_player;
+    if (pub.bag_size !== undefined) state.public.bag_size = pub.bag_size;
+
+    const priv = msg.private || {};
+    if (priv.hand !== undefined) state.private.hand = priv.hand;
+    if (priv.pending_score !== undefined) state.private.pending_score = priv.pending_score;
+    else delete state.private.pending_score;
+
+    state.version = msg.version;
+    onState(state);
+}
+
 function onState(msg) {
     lastState = msg;
     if (!started) { log("Игра началась."); }
@@ -208,7 +271,7 @@ function onState(msg) {
 
     dbg("STATE", {
         current_player: msg.public.current_player,
-        players: msg.public.players,
+        scores: msg.public.scores,
         bag_size: msg.public.bag_size,
         myTurn: myTurn,
         pending_score: msg.private.pending_score,
@@ -248,7 +311,7 @@ function buildEmptyBoard(size) {
             cell.className = "board-cell";
             cell.dataset.x = x;
             cell.dataset.y = y;
-            if (x === 7 && y === 7) cell.classList.add("board-center");
+            if (x === (size >> 1) && y === (size >> 1)) cell.classList.add("board-center");
             cell.onclick = () => onCellClick(x, y);
             board.appendChild(cell);
         }
@@ -317,11 +380,11 @@ function renderHand(hand) {
 function renderPlayers(pub) {
     const list = qs("playersList");
     list.innerHTML = "";
-    (pub.players || []).forEach((pl, idx) => {
+    (setup ? setup.players : []).forEach((id, idx) => {
         const div = document.createElement("div");
         div.className = "player-entry";
         if (idx === pub.current_player) div.classList.add("player-current");
-        div.textContent = `#${pl.id} — ${pl.score}`;
+        div.textContent = `#${id} — ${pub.scores[idx]}`;
         if (idx === pub.current_player) div.textContent += "  ⟵ ход";
         list.appendChild(div);
     });
@@ -50,6 +50,10 @@ CREATE INDEX idx_auth_tokens_expires
 CREATE TABLE games (
     id           INTEGER PRIMARY KEY AUTOINCREMENT,
     host_user_id INTEGER NOT NULL UNIQUE,
+    -- seed of all random draws, replays the game with the same moves
+    seed         INTEGER NOT NULL DEFAULT 0,
+    -- rules the game is played by: standard, super or quick
+    variant      TEXT NOT NULL DEFAULT 'standard',
     FOREIGN KEY (host_user_id) REFERENCES users(id)
     --TODO: add ongoing bool column
     --TODO: add max_players in game
@@ -0,0 +1,40 @@
+#include "Deflate.hpp"
+
+namespace services::websocket {
+
+namespace {
+
+// tail of a sync flush, not sent, see RFC 7692 7.2.1
+constexpr std::string_view kFlushTail{"\x00\x00\xff\xff", 4};
+
+} // namespace
+
+FrameDeflater::FrameDeflater(const int level) {
+    // negative window bits: raw deflate without zlib header and checksum
+    deflateInit2(&stream_, level, Z_DEFLATED, -MAX_WBITS, 8,
+                 Z_DEFAULT_STRATEGY);
+}
+
+FrameDeflater::~FrameDeflater() { deflateEnd(&stream_); }
+
+void FrameDeflater::Deflate(const std::string_view data, std::string &out) {
+    const std::size_t begin = out.size();
+    out.resize(begin + deflateBound(&stream_, data.size()) + 16);
+    stream_.next_in =
+        reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+    stream_.avail_in = static_cast<uInt>(data.size());
+    stream_.next_out = reinterpret_cast<Bytef *>(out.data() + begin);
+    stream_.avail_out = static_cast<uInt>(out.size() - begin);
+    // a sync flush ends the output on a byte with the window kept
+    while (deflate(&stream_, Z_SYNC_FLUSH) == Z_OK && stream_.avail_out == 0) {
+        const std::size_t written = out.size();
+        out.resize(written * 2);
+        stream_.next_out = reinterpret_cast<Bytef *>(out.data() + written);
+        stream_.avail_out = static_cast<uInt>(out.size() - written);
+    }
+    out.resize(out.size() - stream_.avail_out);
+    if (std::string_view(out).ends_with(kFlushTail))
+        out.resize(out.size() - kFlushTail.size());
+}
+
+} // namespace services::websocket
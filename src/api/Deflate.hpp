@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <zlib.h>
+
+namespace services::websocket {
+
+/*
+ * @brief raw deflate of the outgoing frames of one connection, the way
+ * permessage-deflate (RFC 7692) does it with context takeover
+ *
+ * @notes the window is kept from frame to frame, so a state compresses
+ * against the states sent before it; every frame ends with a sync flush
+ * whose 00 00 ff ff tail is dropped, the client appends it back and inflates
+ * every compressed frame of the connection in order with one raw inflate
+ * context
+ */
+class FrameDeflater {
+  public:
+    /*
+     * @param {level} zlib level, 1 fastest .. 9 smallest
+     */
+    explicit FrameDeflater(const int level);
+    ~FrameDeflater();
+
+    FrameDeflater(const FrameDeflater &) = delete;
+    FrameDeflater &operator=(const FrameDeflater &) = delete;
+
+    /*
+     * @brief compressed data appended to out
+     */
+    void Deflate(const std::string_view data, std::string &out);
+
+  private:
+    z_stream stream_{};
+};
+
+} // namespace services::websocket
@@ -1,4 +1,5 @@
 #include "http_handlers.hpp"
+#include <algorithm>
 #include <cstddef>
 #include <memory>
 #include <optional>
@@ -354,11 +355,12 @@ LoginHandler::HandleRequest(server::http::HttpRequest &request,
 /*
  * @brief inserts new game in games
  * @param {user_id} of host user
+ * @param {seed} seed of the game, bits of uint64_t stored as int64_t
  * @retval {id} new game id
  */
 inline constexpr std::string_view SqlInsertNewGame = R"~(
-    INSERT INTO games(host_user_id)
-    VALUES ($1)
+    INSERT INTO games(host_user_id, seed, variant)
+    VALUES ($1, $2, $3)
     RETURNING id
 )~";
 /*
@@ -482,10 +484,33 @@ GameHandler::GameHandler(const components::ComponentConfig &config,
           context.FindComponent<components::SQLite>("sqlitedb").GetClient()),
       game_storage_client_(
           context.FindComponent<ScrabbleGame::StorageComponent>("game_storage")
-              .GetStorage()) {};
+              .GetStorage()),
+      dictionary_(
+          context.FindComponent<ScrabbleGame::DictionaryComponent>()
+              .GetDictionary("ru")),
+      bots_(context.FindComponent<ScrabbleGame::BotComponent>().GetBots()) {}
 
 std::string GameHandler::create_game_(server::http::HttpRequest &request,
                                       const int &user_id) const {
+    // TODO: game settings
+    formats::json::Value json =
+        userver::formats::json::FromString(request.RequestBody());
+    const int bots = std::clamp(json["bots"].As<int>(0), 0, kBotsMax);
+    // a lone host plays the bots, without bots the host waits for one more
+    const int players = json["players"].As<int>(bots > 0 ? 1 : 2);
+    if (players < 1 || players + bots < 2 || players + bots > kSeatsMax) {
+        request.SetResponseStatus(server::http::HttpStatus::kBadRequest);
+        return "InvalidSeats";
+    }
+    const std::string variant_name =
+        json["variant"].As<std::string>("standard");
+    const std::optional<ScrabbleGame::Variant> variant =
+        ScrabbleGame::VariantFromName(variant_name);
+    if (!variant) {
+        request.SetResponseStatus(server::http::HttpStatus::kBadRequest);
+        return "UnknownVariant";
+    }
+
     LOG_DEBUG() << "create_game_: before select";
     // deleting game if already exists
     storages::sqlite::ResultSet select_result =
@@ -503,22 +528,29 @@ std::string GameHandler::create_game_(server::http::HttpRequest &request,
     }
     LOG_DEBUG() << "create_game_: before insert";
 
-    storages::sqlite::ResultSet result =
-        sqlite_client_->Execute(storages::sqlite::OperationType::kReadWrite,
-                                SqlInsertNewGame.data(), user_id);
+    const std::uint64_t seed = ScrabbleGame::Randomizer::RandomSeed();
+    storages::sqlite::ResultSet result = sqlite_client_->Execute(
+        storages::sqlite::OperationType::kReadWrite, SqlInsertNewGame.data(),
+        user_id, static_cast<std::int64_t>(seed), variant_name);
     LOG_DEBUG() << "create_game_: after insert execute";
     const int new_game_id = std::move(result).AsSingleField<int>();
     LOG_DEBUG() << "create_game_: after insert field extract, new_game_id="
-                << new_game_id;
-
-    // TODO: game settings
-
-    ScrabbleGame::ScrabbleGame game([](const std::u32string &) { return 1; });
+                << new_game_id << ", seed=" << seed
+                << ", variant=" << variant_name;
+
+    // bot seats come on top of the human ones, the game starts once the
+    // humans joined
+    ScrabbleGame::ScrabbleGame game(dictionary_, players + bots,
+                                    *variant, seed, defaultTiles,
+                                    ScrabbleGame::kRussianAlphabet);
     auto game_room =
-        std::make_shared<ScrabbleGame::GameRoom>(new_game_id, std::move(game));
+        std::make_shared<ScrabbleGame::GameRoom>(new_game_id, std::move(game),
+                                                 bots_->settings().hint_budget);
     LOG_DEBUG() << "create_game_: before attach_session";
     game_room->attach_session(user_id,
                               std::make_shared<ScrabbleGame::PlayerSession>());
+    for (int bot = 1; bot <= bots; ++bot)
+        game_room->attach_bot(-bot, bots_);
     LOG_DEBUG() << "create_game_: before new_room";
     game_storage_client_->new_room(game_room);
     LOG_DEBUG() << "create_game_: done";
@@ -20,6 +20,8 @@
 
 #include <userver/logging/log.hpp>
 
+#include "dictionary/DictionaryComponent.hpp"
+#include "session/BotPlayer.hpp"
 #include "session/GameStorage.hpp"
 
 using namespace userver;
@@ -137,9 +139,15 @@ class GameHandler final : public server::handlers::HttpHandlerBase {
     enum class GameAction { join, create, end, start, list };
     GameAction from_string_GameAction(const std::string &str) const;
 
+    // max bot seats of one game
+    static constexpr int kBotsMax = 3;
+    // max seats of one game, humans and bots
+    static constexpr int kSeatsMax = 4;
+
     /*
      * @brief creates new game with current user as host
      * @param {"token"} user token
+     * @param {"bots"} optional number of bot seats, 0 by default
      * @returns new game id in body
      */
     std::string create_game_(server::http::HttpRequest &request,
@@ -194,6 +202,12 @@ class GameHandler final : public server::handlers::HttpHandlerBase {
     storages::sqlite::ClientPtr sqlite_client_;
 
     std::shared_ptr<ScrabbleGame::StorageClient> game_storage_client_;
+
+    // words accepted in new games, owned by DictionaryComponent
+    ScrabbleGame::DictionaryHandle dictionary_;
+
+    // plays turns of bot seats, owned by BotComponent
+    std::shared_ptr<ScrabbleGame::BotClient> bots_;
 };
 
 } // namespace services::http
@@ -1,8 +1,10 @@
 #include "websocket.hpp"
 #include "utils/utils.hpp"
+#include <ctime>
 #include <memory>
 #include <optional>
 #include <string_view>
+#include <userver/components/statistics_storage.hpp>
 #include <userver/crypto/crypto.hpp>
 #include <userver/engine/async.hpp>
 #include <userver/engine/sleep.hpp>
@@ -12,6 +14,8 @@
 #include <userver/server/websocket/server.hpp>
 #include <userver/storages/sqlite/operation_types.hpp>
 #include <userver/storages/sqlite/result_set.hpp>
+#include <userver/utils/statistics/writer.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
 #include <vector>
 
 #define MAX_SEQ 20
@@ -56,6 +60,34 @@ inline constexpr std::string_view SqlGetAllPlayers = R"~(
 
 namespace services::websocket {
 
+namespace {
+
+std::uint64_t ThreadCpuNs() {
+    timespec time{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return static_cast<std::uint64_t>(time.tv_sec) * 1'000'000'000 +
+           time.tv_nsec;
+}
+
+void DumpCompressionStatistics(utils::statistics::Writer &writer,
+                               const CompressionStatistics &statistics) {
+    const std::uint64_t frames = statistics.compressed_frames;
+    const std::uint64_t bytes_in = statistics.bytes_in;
+    const std::uint64_t bytes_out = statistics.bytes_out;
+    const std::uint64_t cpu_ns = statistics.cpu_ns;
+    writer["frames"]["compressed"] = frames;
+    writer["frames"]["skipped"] = statistics.skipped_frames.load();
+    writer["bytes"]["in"] = bytes_in;
+    writer["bytes"]["out"] = bytes_out;
+    writer["cpu-ns"] = cpu_ns;
+    if (frames != 0) {
+        writer["ratio"] = static_cast<double>(bytes_out) / bytes_in;
+        writer["cpu-ns-per-frame"] = cpu_ns / frames;
+    }
+}
+
+} // namespace
+
 WebsocketsHandler::WebsocketsHandler(
     const components::ComponentConfig &config,
     const components::ComponentContext &context)
@@ -64,33 +96,87 @@ WebsocketsHandler::WebsocketsHandler(
           context.FindComponent<components::SQLite>("sqlitedb").GetClient()),
       game_storage_client_(
           context.FindComponent<ScrabbleGame::StorageComponent>("game_storage")
-              .GetStorage()) {};
+              .GetStorage()),
+      compression_{config["compression-enabled"].As<bool>(false),
+                   config["compression-threshold"].As<std::size_t>(512),
+                   config["compression-level"].As<int>(1)} {
+    statistics_entry_ =
+        context.FindComponent<components::StatisticsStorage>()
+            .GetStorage()
+            .RegisterWriter("websocket-compression",
+                            [this](utils::statistics::Writer &writer) {
+                                DumpCompressionStatistics(
+                                    writer, compression_statistics_);
+                            });
+}
+
+WebsocketsHandler::~WebsocketsHandler() { statistics_entry_.Unregister(); }
+
+yaml_config::Schema WebsocketsHandler::GetStaticConfigSchema() {
+    return yaml_config::MergeSchemas<server::websocket::WebsocketHandlerBase>(
+        R"(
+type: object
+description: websocket of game rooms
+additionalProperties: false
+properties:
+    compression-enabled:
+        type: boolean
+        description: deflate frames of connections that ask for it
+        defaultDescription: false
+    compression-threshold:
+        type: integer
+        description: frames smaller than this many bytes are not deflated
+        defaultDescription: 512
+        minimum: 0
+    compression-level:
+        type: integer
+        description: zlib level, 1 fastest .. 9 smallest
+        defaultDescription: 1
+        minimum: 1
+        maximum: 9
+)");
+}
 
 void WebsocketsHandler::Handle(server::websocket::WebSocketConnection &chat,
                                server::request::RequestContext &) const {
-    const auto [game_id, user_id] = init_user_id_(chat);
+    const Handshake handshake = init_user_id_(chat);
+    const int user_id = handshake.user_id;
     std::shared_ptr<ScrabbleGame::GameRoom> game =
-        game_storage_client_->get_game_room(game_id);
+        game_storage_client_->get_game_room(handshake.game_id);
+    game->set_protocol(user_id, handshake.protocol);
     LOG_DEBUG() << "GameRoom with id = " << game->game_id() << " was received";
+    // one context per connection, frames are deflated against the previous
+    std::optional<FrameDeflater> deflater;
+    if (handshake.deflate)
+        deflater.emplace(compression_.level);
     engine::Mutex mutex;
-    auto send_loop =
-        engine::AsyncNoSpan([&chat, &mutex, &game, &user_id, this] {
-            send_loop_(chat, mutex, game, user_id);
+    auto send_loop = engine::AsyncNoSpan(
+        [&chat, &mutex, &game, &user_id, &deflater, this] {
+            send_loop_(chat, mutex, game, user_id,
+                       deflater ? &*deflater : nullptr);
         });
     read_loop_(chat, mutex, game, user_id);
 
     return;
 }
 
-std::pair<u_int64_t, int> WebsocketsHandler::init_user_id_(
+WebsocketsHandler::Handshake WebsocketsHandler::init_user_id_(
     server::websocket::WebSocketConnection &chat) const {
     server::websocket::Message msg;
     chat.Recv(msg);
-    const std::string token =
-        formats::json::FromString(msg.data)["token"].As<std::string>();
+    const formats::json::Value handshake = formats::json::FromString(msg.data);
+    const std::string token = handshake["token"].As<std::string>();
     const int user_id = define_user_id_from_token_(token);
-    const u_int64_t game_id =
-        formats::json::FromString(msg.data)["game_id"].As<u_int64_t>();
+    const u_int64_t game_id = handshake["game_id"].As<u_int64_t>();
+    const std::optional<ScrabbleGame::Protocol> protocol =
+        ScrabbleGame::ProtocolFromName(
+            handshake["protocol"].As<std::string>("json"));
+    if (!protocol) {
+        chat.Close(
+            userver::v2_16_rc::server::websocket::CloseStatus::kBadMessageData);
+        throw server::handlers::ClientError(
+            server::handlers::ExternalBody{"Unknown protocol"});
+    }
     std::shared_ptr<ScrabbleGame::GameRoom> game =
         game_storage_client_->get_game_room(game_id);
     if (!game) {
@@ -105,40 +191,65 @@ std::pair<u_int64_t, int> WebsocketsHandler::init_user_id_(
         throw server::handlers::ClientError(
             server::handlers::ExternalBody{"User has not joined in game"});
     }
-    return {game_id, user_id};
+    // only "deflate" is known, anything else is sent uncompressed
+    const bool deflate =
+        compression_.enabled &&
+        handshake["compression"].As<std::string>("") == "deflate";
+    return {game_id, user_id, *protocol, deflate};
 }
 
 void WebsocketsHandler::send_loop_(server::websocket::WebSocketConnection &chat,
                                    engine::Mutex &mutex,
                                    std::shared_ptr<ScrabbleGame::GameRoom> game,
-                                   const int &user_id) const {
+                                   const int &user_id,
+                                   FrameDeflater *deflater) const {
     LOG_DEBUG() << "Started asyncrous send loop";
     // Serve the connection for as long as the session is open: this covers the
     // pre-start lobby (game not ongoing yet) as well as the running game. The
     // loop ends when the session is closed (client disconnect or game end, both
     // of which call close_session() -> PlayerSession::Close()).
     while (game->session_open()) {
-        std::string msg_to_user = game->wait_for_message(user_id);
+        ScrabbleGame::OutgoingMessage msg_to_user =
+            game->wait_for_message(user_id);
         // close_session() woke us up with nothing to send: stop instead of
         // pushing onto a closing connection.
         if (!game->session_open())
             break;
         server::websocket::Message msg;
-        msg.data = std::move(msg_to_user);
-        // Mark as a text frame: without this userver sends a binary frame, and
-        // browsers hand binary frames to onmessage as a Blob (not a string), so
-        // the JS JSON.parse fails / the message looks "missing". The Python
-        // test client accepts bytes, which is why tests passed but the browser
-        // never saw the payload.
-        msg.is_text = true;
+        msg.data = std::move(msg_to_user.data);
+        // Json must go as a text frame: without this userver sends a binary
+        // frame, and browsers hand binary frames to onmessage as a Blob (not
+        // a string), so the JS JSON.parse fails / the message looks
+        // "missing". Only frames of the binary protocol are binary.
+        msg.is_text = msg_to_user.is_text;
+        if (deflater)
+            compress_(*deflater, msg);
         std::unique_lock<engine::Mutex> lock(mutex);
         LOG_DEBUG() << "Sending message to user=" << user_id
-                    << " message = " << msg.data;
+                    << " size = " << msg.data.size();
         chat.Send(msg);
     }
     LOG_DEBUG() << "send_loop_: session closed, stopping";
     return;
 }
+void WebsocketsHandler::compress_(FrameDeflater &deflater,
+                                  server::websocket::Message &msg) const {
+    if (msg.data.size() < compression_.threshold) {
+        ++compression_statistics_.skipped_frames;
+        return;
+    }
+    const std::uint64_t start = ThreadCpuNs();
+    std::string frame(
+        1, static_cast<char>(ScrabbleGame::BinaryProtocol::Frame::deflated));
+    deflater.Deflate(msg.data, frame);
+    compression_statistics_.cpu_ns += ThreadCpuNs() - start;
+    ++compression_statistics_.compressed_frames;
+    compression_statistics_.bytes_in += msg.data.size();
+    compression_statistics_.bytes_out += frame.size();
+    msg.data = std::move(frame);
+    msg.is_text = false;
+}
+
 void WebsocketsHandler::read_loop_(server::websocket::WebSocketConnection &chat,
                                    engine::Mutex &mutex,
                                    std::shared_ptr<ScrabbleGame::GameRoom> game,
@@ -157,15 +268,18 @@ void WebsocketsHandler::read_loop_(server::websocket::WebSocketConnection &chat,
         }
         LOG_DEBUG() << "read_loop_: got message from user = " << user_id
                     << ", close_status=" << (bool)msg.close_status
-                    << " data=" << msg.data;
+                    << " size=" << msg.data.size();
         // TODO: rework this step with atomic bool (I dont remember why :( )
         if (msg.close_status) {
             chat.Close(*msg.close_status);
             game->close_session(user_id);
             return;
         }
-        game->receive_message(user_id, msg.data);
-        LOG_DEBUG() << "read_loop_: message processed " << msg.data;
+        if (msg.is_text)
+            game->receive_message(user_id, msg.data);
+        else
+            game->receive_binary_message(user_id, msg.data);
+        LOG_DEBUG() << "read_loop_: message processed";
     }
     return;
 }
@@ -1,14 +1,46 @@
 #pragma once
+#include "Deflate.hpp"
 #include "session/GameStorage.hpp"
+#include <atomic>
+#include <cstdint>
 #include <userver/server/websocket/websocket_handler.hpp>
 #include <userver/storages/sqlite/client.hpp>
 #include <userver/storages/sqlite/component.hpp>
 #include <userver/storages/sqlite/operation_types.hpp>
+#include <userver/utils/statistics/entry.hpp>
+#include <userver/yaml_config/schema.hpp>
 
 namespace services::websocket {
 
 using namespace userver;
 
+/*
+ * @brief deflate of outgoing frames, off unless the static config enables
+ * it, and then only for connections that ask for it
+ */
+struct CompressionSettings {
+    bool enabled = false;
+    // smaller frames are sent as they are
+    std::size_t threshold = 512;
+    // zlib level, 1 fastest .. 9 smallest
+    int level = 1;
+};
+
+/*
+ * @brief totals of the frames of connections with deflate, dumped as
+ * metrics "websocket-compression"
+ */
+struct CompressionStatistics {
+    std::atomic<std::uint64_t> compressed_frames{0};
+    // frames under CompressionSettings::threshold
+    std::atomic<std::uint64_t> skipped_frames{0};
+    // sizes of compressed frames before and after deflate
+    std::atomic<std::uint64_t> bytes_in{0};
+    std::atomic<std::uint64_t> bytes_out{0};
+    // cpu time spent in deflate
+    std::atomic<std::uint64_t> cpu_ns{0};
+};
+
 class WebsocketsHandler final : public server::websocket::WebsocketHandlerBase {
   public:
     // `kName` is used as the component name in static config
@@ -20,17 +52,40 @@ class WebsocketsHandler final : public server::websocket::WebsocketHandlerBase {
     // Component is valid after construction and is able to accept requests
     using WebsocketHandlerBase::WebsocketHandlerBase;
 
+    ~WebsocketsHandler() override;
+
     void Handle(server::websocket::WebSocketConnection &chat,
                 server::request::RequestContext &) const override;
 
+    static yaml_config::Schema GetStaticConfigSchema();
+
   private:
+    /*
+     * @brief what the first message of a connection asks for
+     */
+    struct Handshake {
+        u_int64_t game_id;
+        int user_id;
+        ScrabbleGame::Protocol protocol;
+        // frames over the threshold are deflated, see FrameDeflater
+        bool deflate;
+    };
+
     /*
      * @info sends msg with game_info to user
      */
     void send_loop_(server::websocket::WebSocketConnection &chat,
                     engine::Mutex &mutex,
                     std::shared_ptr<ScrabbleGame::GameRoom> game,
-                    const int &user_id) const;
+                    const int &user_id, FrameDeflater *deflater) const;
+
+    /*
+     * @brief deflates msg in place if it is over the threshold
+     * @note a deflated frame is binary: BinaryProtocol::Frame::deflated, then
+     *       the deflated data of the frame
+     */
+    void compress_(FrameDeflater &deflater,
+                   server::websocket::Message &msg) const;
     /*
      * @info waits for user input msg with 100ms sleep
      */
@@ -57,11 +112,12 @@ class WebsocketsHandler final : public server::websocket::WebsocketHandlerBase {
 
     /*
      * @brief Receives first message which describes connection
-     * @receives "token" of user
-     * @returns {game_id, user_id}
+     * @receives "token" of user, "game_id" and optional "protocol" of the
+     * next frames, "json" (default) or "binary", see BinaryProtocol,
+     * optional "compression": "deflate"
      * @throws ClientError
      */
-    std::pair<u_int64_t, int>
+    Handshake
     init_user_id_(server::websocket::WebSocketConnection &chat) const;
 
     template <typename T>
@@ -76,6 +132,11 @@ class WebsocketsHandler final : public server::websocket::WebsocketHandlerBase {
     storages::sqlite::ClientPtr sqlite_client_;
 
     std::shared_ptr<ScrabbleGame::StorageClient> game_storage_client_;
+
+    const CompressionSettings compression_;
+    mutable CompressionStatistics compression_statistics_;
+    // declared after the statistics it reads, so it is removed first
+    utils::statistics::Entry statistics_entry_;
 };
 
 } // namespace services::websocket
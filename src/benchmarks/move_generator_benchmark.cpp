@@ -0,0 +1,193 @@
+#include "game/ScrabbleGame.hpp"
+
+#include <random>
+
+#include <benchmark/benchmark.h>
+#include <userver/engine/run_standalone.hpp>
+#include <userver/engine/task/current_task.hpp>
+
+namespace {
+
+using ScrabbleGame::Letter;
+
+/*
+ * @brief dictionary of random words drawn from the tile distribution, word
+ * lengths roughly follow those of a dictionary of nouns
+ */
+const ScrabbleGame::Dawg &SyntheticDictionary() {
+    static const ScrabbleGame::Dawg dawg = [] {
+        std::mt19937 random(7);
+        std::discrete_distribution<int> length(
+            {0, 0, 0.05, 0.5, 2.5, 6, 10, 14, 15, 14, 12, 9, 7, 5, 3, 2});
+        std::uniform_int_distribution<std::size_t> tile(
+            0, defaultTiles.size() - 1);
+        std::vector<ScrabbleGame::Word> words(100'000);
+        for (auto &word : words) {
+            word.resize(length(random));
+            for (Letter &letter : word)
+                letter = defaultTiles[tile(random)];
+        }
+        return ScrabbleGame::Dawg::FromWords(std::move(words));
+    }();
+    return dawg;
+}
+
+/*
+ * @brief board after turns of the best moves of random hands
+ */
+ScrabbleGame::Board CrowdedBoard(const int turns) {
+    const auto &dawg = SyntheticDictionary();
+    const auto &alphabet = ScrabbleGame::kRussianAlphabet;
+    std::mt19937 random(7);
+    std::uniform_int_distribution<std::size_t> tile(
+        0, defaultTiles.size() - 1);
+
+    ScrabbleGame::Board board;
+    ScrabbleGame::CrossChecks cross_checks;
+    for (int turn = 0; turn < turns; ++turn) {
+        std::vector<Letter> hand(ScrabbleGame::PlacementOverlay::kMaxTiles);
+        for (Letter &letter : hand)
+            letter = defaultTiles[tile(random)];
+        cross_checks.Rebuild(board, &dawg, alphabet);
+        const auto moves =
+            ScrabbleGame::MoveGenerator(dawg, alphabet, board, cross_checks)
+                .Generate(hand, 1);
+        if (moves.empty())
+            continue;
+        const auto coordinates = moves.front().coordinates();
+        const auto tiles = moves.front().tiles();
+        for (std::size_t i = 0; i < tiles.size(); ++i)
+            board.set(coordinates[i][0], coordinates[i][1], tiles[i]);
+    }
+    return board;
+}
+
+} // namespace
+
+/*
+ * @brief cost of a hint of 10 moves for a 7-tile hand, arguments are the
+ * number of turns played before and the number of blanks in hand
+ */
+void MoveGeneration(benchmark::State &state) {
+    const auto &dawg = SyntheticDictionary();
+    const auto &alphabet = ScrabbleGame::kRussianAlphabet;
+    const ScrabbleGame::Board board = CrowdedBoard(state.range(0));
+    ScrabbleGame::CrossChecks cross_checks;
+    cross_checks.Rebuild(board, &dawg, alphabet);
+
+    std::vector<Letter> hand{1, 6, 15, 18, 19, 9, 14};
+    for (int i = 0; i < state.range(1); ++i)
+        hand[hand.size() - 1 - i] = ScrabbleGame::kBlank;
+
+    const ScrabbleGame::MoveGenerator generator(dawg, alphabet, board,
+                                                cross_checks);
+    for ([[maybe_unused]] auto _ : state)
+        benchmark::DoNotOptimize(generator.Generate(hand, 10));
+}
+BENCHMARK(MoveGeneration)
+    ->ArgsProduct({{0, 10, 25}, {0, 1, 2}})
+    ->Unit(benchmark::kMillisecond);
+
+/*
+ * @brief wall time of a deep search of 100 moves for a hand with two blanks
+ * on a crowded board, split between as many workers as the task processor
+ * has threads, the argument
+ */
+void MoveGenerationParallel(benchmark::State &state) {
+    const auto &dawg = SyntheticDictionary();
+    const auto &alphabet = ScrabbleGame::kRussianAlphabet;
+    const ScrabbleGame::Board board = CrowdedBoard(25);
+    ScrabbleGame::CrossChecks cross_checks;
+    cross_checks.Rebuild(board, &dawg, alphabet);
+
+    const std::vector<Letter> hand{1,  6,  15, 18, 19, ScrabbleGame::kBlank,
+                                   ScrabbleGame::kBlank};
+    const auto workers = static_cast<std::size_t>(state.range(0));
+    userver::engine::RunStandalone(workers, [&] {
+        auto &task_processor =
+            userver::engine::current_task::GetTaskProcessor();
+        const ScrabbleGame::MoveGenerator generator(dawg, alphabet, board,
+                                                    cross_checks);
+        for ([[maybe_unused]] auto _ : state)
+            benchmark::DoNotOptimize(generator.Generate(
+                hand, 100, ScrabbleGame::MoveGenerator::Deadline::max(),
+                task_processor, workers));
+    });
+}
+BENCHMARK(MoveGenerationParallel)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+/*
+ * @brief time to solve an endgame of two 7-tile hands on a crowded board,
+ * the argument is the number of moves tried in a position; the nodes counter
+ * is the number of positions searched per second
+ */
+void EndgameSolve(benchmark::State &state) {
+    const auto &dawg = SyntheticDictionary();
+    const auto &alphabet = ScrabbleGame::kRussianAlphabet;
+    const ScrabbleGame::Board board = CrowdedBoard(20);
+    ScrabbleGame::CrossChecks cross_checks;
+    cross_checks.Rebuild(board, &dawg, alphabet);
+
+    const std::vector<Letter> hand{1, 6, 15, 18, 19, 9, 14};
+    const std::vector<Letter> opponent_hand{2, 10, 16, 1, 20, 12, 6};
+    ScrabbleGame::EndgameSolver::Options options;
+    options.width = state.range(0);
+    ScrabbleGame::EndgameSolver solver(dawg, alphabet, options);
+    std::uint64_t nodes = 0;
+    for ([[maybe_unused]] auto _ : state) {
+        const auto result =
+            solver.Solve(board, cross_checks, hand, opponent_hand);
+        nodes += result.nodes;
+        state.counters["depth"] = result.depth;
+        state.counters["solved"] = result.solved;
+    }
+    state.counters["nodes"] =
+        benchmark::Counter(nodes, benchmark::Counter::kIsRate);
+}
+BENCHMARK(EndgameSolve)
+    ->RangeMultiplier(2)
+    ->Range(4, 16)
+    ->Unit(benchmark::kMillisecond);
+
+/*
+ * @brief cost of computing cross checks of every cell, done before each hint
+ */
+void CrossChecksRebuild(benchmark::State &state) {
+    const auto &dawg = SyntheticDictionary();
+    const ScrabbleGame::Board board = CrowdedBoard(25);
+    ScrabbleGame::CrossChecks cross_checks;
+    for ([[maybe_unused]] auto _ : state) {
+        cross_checks.Rebuild(board, &dawg, ScrabbleGame::kRussianAlphabet);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(CrossChecksRebuild);
+
+/*
+ * @brief cost of the update SubmitWord does instead of a rebuild, for the
+ * cells of four tiles
+ */
+void CrossChecksUpdate(benchmark::State &state) {
+    const auto &dawg = SyntheticDictionary();
+    const ScrabbleGame::Board board = CrowdedBoard(25);
+    ScrabbleGame::CrossChecks cross_checks;
+    cross_checks.Rebuild(board, &dawg, ScrabbleGame::kRussianAlphabet);
+
+    std::vector<std::vector<int>> coordinates;
+    for (int x = 0; x < ScrabbleGame::Board::kWidth; ++x) {
+        for (int y = 0; y < ScrabbleGame::Board::kHeight; ++y) {
+            if (!board.empty(x, y) && coordinates.size() < 4)
+                coordinates.push_back({x, y});
+        }
+    }
+    for ([[maybe_unused]] auto _ : state) {
+        cross_checks.Update(board, &dawg, ScrabbleGame::kRussianAlphabet,
+                            coordinates);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(CrossChecksUpdate);
@@ -0,0 +1,77 @@
+#include "session/BinaryProtocol.hpp"
+#include "utils/utils.hpp"
+
+#include <benchmark/benchmark.h>
+#include <userver/formats/json/serialize.hpp>
+
+namespace {
+
+const std::vector<std::vector<int>> kCoordinates{
+    {6, 8}, {6, 9}, {6, 10}, {6, 11}};
+
+ScrabbleGame::ScrabbleGame MakeGame() {
+    ScrabbleGame::ScrabbleGame game{ScrabbleGame::DictionaryHandle{}};
+    game.set_players({1, 2});
+    return game;
+}
+
+} // namespace
+
+/*
+ * @brief parse of a json `place` command, as GameRoom reads it
+ */
+void CommandJson(benchmark::State &state) {
+    const std::string msg =
+        R"({"action":"place","coordinates":[[6,8],[6,9],[6,10],[6,11]],)"
+        R"("letters":"АРКА"})";
+    for ([[maybe_unused]] auto _ : state) {
+        const auto json = userver::formats::json::FromString(msg);
+        ScrabbleGame::PlayerCommand command;
+        benchmark::DoNotOptimize(json["action"].As<std::string>());
+        command.coordinates =
+            json["coordinates"].As<std::vector<std::vector<int>>>();
+        std::string letters = json["letters"].As<std::string>();
+        command.tiles =
+            utf8str_to_letters_(ScrabbleGame::kRussianAlphabet, letters);
+        benchmark::DoNotOptimize(command);
+    }
+}
+BENCHMARK(CommandJson);
+
+/*
+ * @brief the same command in the binary protocol
+ */
+void CommandBinary(benchmark::State &state) {
+    ScrabbleGame::PlayerCommand place;
+    place.action = ScrabbleGame::PlayerAction::place;
+    place.coordinates = kCoordinates;
+    place.tiles = {1, 2, 3, 1};
+    const std::string msg = ScrabbleGame::BinaryProtocol::EncodeCommand(place);
+    const std::span<const std::uint8_t> bytes(
+        reinterpret_cast<const std::uint8_t *>(msg.data()), msg.size());
+    for ([[maybe_unused]] auto _ : state)
+        benchmark::DoNotOptimize(
+            ScrabbleGame::BinaryProtocol::DecodeCommand(bytes));
+}
+BENCHMARK(CommandBinary);
+
+/*
+ * @brief encoding of the full public state, once per published version
+ */
+void PublicStateJson(benchmark::State &state) {
+    const ScrabbleGame::ScrabbleGame game = MakeGame();
+    const ScrabbleGame::ViewBuilder views(game);
+    for ([[maybe_unused]] auto _ : state)
+        benchmark::DoNotOptimize(views.public_state());
+}
+BENCHMARK(PublicStateJson);
+
+void PublicStateBinary(benchmark::State &state) {
+    const ScrabbleGame::ScrabbleGame game = MakeGame();
+    const ScrabbleGame::ViewBuilder views(game);
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(
+            ScrabbleGame::BinaryProtocol::PublicState(views.view()));
+    }
+}
+BENCHMARK(PublicStateBinary);
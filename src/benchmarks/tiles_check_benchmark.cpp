@@ -0,0 +1,66 @@
+#include "game/ScrabbleGame.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+std::vector<ScrabbleGame::Letter> Letters(std::u32string_view word) {
+    std::vector<ScrabbleGame::Letter> letters;
+    for (const char32_t c : word)
+        letters.push_back(ScrabbleGame::kRussianAlphabet.encode(c));
+    return letters;
+}
+
+ScrabbleGame::ScrabbleGame MakeMidgame() {
+    ScrabbleGame::ScrabbleGame game{ScrabbleGame::DictionaryHandle{}};
+    game.set_players({1, 2});
+
+    // a few committed words so placements have neighbours to read
+    game.TryPlaceTiles({{5, 7}, {6, 7}, {7, 7}, {8, 7}, {9, 7}},
+                       Letters(U"СЛОВО"));
+    game.SubmitWord();
+    game.TryPlaceTiles({{7, 3}, {7, 4}, {7, 5}, {7, 6}}, Letters(U"ДОМИ"));
+    game.SubmitWord();
+    game.TryPlaceTiles({{9, 8}, {9, 9}, {9, 10}}, Letters(U"КНО"));
+    game.SubmitWord();
+    return game;
+}
+
+} // namespace
+
+/*
+ * @brief cost of one `place` validation of four tiles crossing committed
+ * words, as done for every `place` message while a client drags tiles
+ */
+void TilesCheck(benchmark::State &state) {
+    ScrabbleGame::ScrabbleGame game = MakeMidgame();
+    const std::vector<std::vector<int>> coordinates{
+        {6, 8}, {6, 9}, {6, 10}, {6, 11}};
+    const std::vector<ScrabbleGame::Letter> tiles = Letters(U"АРКА");
+
+    for ([[maybe_unused]] auto _ : state) {
+        auto coordinates_copy = coordinates;
+        auto tiles_copy = tiles;
+        benchmark::DoNotOptimize(game.TryPlaceTiles(std::move(coordinates_copy),
+                                                    std::move(tiles_copy)));
+    }
+}
+BENCHMARK(TilesCheck);
+
+/*
+ * @brief same validation rejected early because a tile lands on an occupied
+ * cell, the common case while a tile is dragged over the board
+ */
+void TilesCheckOccupied(benchmark::State &state) {
+    ScrabbleGame::ScrabbleGame game = MakeMidgame();
+    const std::vector<std::vector<int>> coordinates{{7, 7}};
+    const std::vector<ScrabbleGame::Letter> tiles = Letters(U"А");
+
+    for ([[maybe_unused]] auto _ : state) {
+        auto coordinates_copy = coordinates;
+        auto tiles_copy = tiles;
+        benchmark::DoNotOptimize(game.TryPlaceTiles(std::move(coordinates_copy),
+                                                    std::move(tiles_copy)));
+    }
+}
+BENCHMARK(TilesCheckOccupied);
@@ -0,0 +1,91 @@
+#include "game/GameViewBuilder.hpp"
+#include "utils/utils.hpp"
+
+#include <benchmark/benchmark.h>
+#include <userver/formats/json/serialize.hpp>
+#include <userver/formats/json/value_builder.hpp>
+
+namespace {
+
+/*
+ * @brief public state the way it was built before JsonWriter: a DOM with a
+ * string per cell, then ToStableString sorting the keys
+ */
+std::string DomPublicState(const ScrabbleGame::ScrabbleGame &game) {
+    using namespace ScrabbleGame;
+    const GameState &state = game.get_game_state();
+    userver::formats::json::ValueBuilder json_vb;
+    json_vb["current_player"] = state.current_player;
+    json_vb["bag_size"] = state.bag.size();
+    json_vb["scores"].Resize(state.playersState.size());
+    for (size_t i = 0; i < state.playersState.size(); ++i)
+        json_vb["scores"][i] = state.playersState[i].score;
+    game.visit_board([&]<Variant V>(const BasicBoard<V> &board) {
+        json_vb["letters"].Resize(board.kWidth);
+        for (int x = 0; x < board.kWidth; ++x) {
+            json_vb["letters"][x].Resize(board.kHeight);
+            for (int y = 0; y < board.kHeight; ++y) {
+                json_vb["letters"][x][y] =
+                    board.empty(x, y)
+                        ? std::string(" ")
+                        : Char32ToUtf8(game.alphabet().decode(board.at(x, y)));
+            }
+        }
+    });
+    return userver::formats::json::ToStableString(json_vb.ExtractValue());
+}
+
+ScrabbleGame::ScrabbleGame MakeGame(const int variant) {
+    ScrabbleGame::ScrabbleGame game{ScrabbleGame::DictionaryHandle{}, 2,
+                                    ScrabbleGame::Variant(variant)};
+    game.set_players({1, 2});
+    return game;
+}
+
+} // namespace
+
+/*
+ * @brief public state of a board of variant state.range(0) through a DOM
+ */
+void PublicStateDom(benchmark::State &state) {
+    const ScrabbleGame::ScrabbleGame game = MakeGame(state.range(0));
+    for ([[maybe_unused]] auto _ : state)
+        benchmark::DoNotOptimize(DomPublicState(game));
+}
+BENCHMARK(PublicStateDom)->Arg(0)->Arg(1);
+
+/*
+ * @brief the same state by JsonWriter, one allocation of the reserved
+ * string
+ */
+void PublicStateWriter(benchmark::State &state) {
+    const ScrabbleGame::ScrabbleGame game = MakeGame(state.range(0));
+    const ScrabbleGame::ViewBuilder views(game);
+    for ([[maybe_unused]] auto _ : state)
+        benchmark::DoNotOptimize(views.public_state());
+}
+BENCHMARK(PublicStateWriter)->Arg(0)->Arg(1);
+
+/*
+ * @brief serialization of one broadcast to state.range(0) players: the
+ * public part once, then the private part and the message of every player
+ */
+void BroadcastStates(benchmark::State &state) {
+    const int players_num = state.range(0);
+    ScrabbleGame::ScrabbleGame game{ScrabbleGame::DictionaryHandle{},
+                                    players_num};
+    std::vector<int64_t> players;
+    for (int i = 1; i <= players_num; ++i)
+        players.push_back(i);
+    game.set_players(players);
+
+    for ([[maybe_unused]] auto _ : state) {
+        const ScrabbleGame::ViewBuilder views(game);
+        const std::string public_state = views.public_state();
+        for (const int64_t player_id : players) {
+            benchmark::DoNotOptimize(ScrabbleGame::ViewBuilder::state_message(
+                1, public_state, views.private_state(player_id)));
+        }
+    }
+}
+BENCHMARK(BroadcastStates)->Arg(2)->Arg(4);
@@ -0,0 +1,290 @@
+#include "Dawg.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "utfcpp/source/utf8.h"
+
+namespace ScrabbleGame {
+
+namespace {
+
+/*
+ * @brief builds minimized automaton from sorted words, Daciuk et al.
+ * incremental algorithm: a node is minimized as soon as no later word can
+ * pass through it
+ */
+class DawgBuilder {
+  public:
+    struct Node {
+        bool final = false;
+        // sorted by letter, because words come sorted
+        std::vector<std::pair<Letter, std::uint32_t>> edges;
+    };
+
+    DawgBuilder() : nodes_(1), path_{0} {}
+
+    /*
+     * @param {word} must not be less than previous added word
+     */
+    void add(const Word &word) {
+        std::size_t prefix = 0;
+        while (prefix < word.size() && prefix < previous_.size() &&
+               word[prefix] == previous_[prefix])
+            ++prefix;
+        if (prefix == word.size() && prefix == previous_.size())
+            return;
+
+        minimize_(prefix);
+        for (std::size_t i = prefix; i < word.size(); ++i) {
+            const auto child = static_cast<std::uint32_t>(nodes_.size());
+            nodes_.emplace_back();
+            nodes_[path_.back()].edges.emplace_back(word[i], child);
+            path_.push_back(child);
+        }
+        nodes_[path_.back()].final = true;
+        previous_ = word;
+    }
+
+    /*
+     * @brief minimizes what is left, root is nodes()[0]
+     */
+    const std::vector<Node> &finish() {
+        minimize_(0);
+        return nodes_;
+    }
+
+  private:
+    std::vector<Node> nodes_;
+    // nodes on the way of previous word, path_[0] is root
+    std::vector<std::uint32_t> path_;
+    Word previous_;
+    std::unordered_map<std::string, std::uint32_t> register_;
+
+    std::string signature_(const Node &node) const {
+        std::string signature(1, node.final ? '1' : '0');
+        for (const auto &[letter, child] : node.edges) {
+            signature.push_back(static_cast<char>(letter));
+            signature.append(reinterpret_cast<const char *>(&child),
+                             sizeof(child));
+        }
+        return signature;
+    }
+
+    /*
+     * @brief replaces nodes of previous word deeper than depth with
+     * equivalent registered ones or registers them
+     */
+    void minimize_(const std::size_t depth) {
+        for (std::size_t i = path_.size() - 1; i > depth; --i) {
+            const std::uint32_t child = path_[i];
+            auto [it, inserted] =
+                register_.emplace(signature_(nodes_[child]), child);
+            if (!inserted) {
+                nodes_[path_[i - 1]].edges.back().second = it->second;
+                nodes_[child].edges = {};
+            }
+        }
+        path_.resize(depth + 1);
+    }
+};
+
+} // namespace
+
+static_assert(std::endian::native == std::endian::little,
+              "Dictionary images are little endian and mapped as is");
+
+Dawg::Dawg() {
+    auto edges = std::make_shared<const std::vector<std::uint32_t>>(1, 0);
+    edges_ = edges->data();
+    edges_count_ = edges->size();
+    storage_ = std::move(edges);
+}
+
+Dawg Dawg::FromWords(std::vector<Word> words) {
+    for (Word &word : words) {
+        for (Letter &letter : word)
+            letter &= kLetterMask;
+    }
+    std::sort(words.begin(), words.end());
+
+    DawgBuilder builder;
+    for (const Word &word : words) {
+        if (!word.empty())
+            builder.add(word);
+    }
+    const std::vector<DawgBuilder::Node> &nodes = builder.finish();
+
+    // lay out reachable nodes breadth first, edge 0 stays unused so that
+    // child index 0 can mean "no child"
+    std::vector<std::uint32_t> first_edge(nodes.size(), 0);
+    std::vector<std::uint32_t> order{0};
+    std::uint32_t next_edge = 1;
+    first_edge[0] = nodes[0].edges.empty() ? 0 : next_edge;
+    next_edge += nodes[0].edges.size();
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        for (const auto &[letter, child] : nodes[order[i]].edges) {
+            if (first_edge[child] != 0 || nodes[child].edges.empty())
+                continue;
+            first_edge[child] = next_edge;
+            next_edge += nodes[child].edges.size();
+            order.push_back(child);
+        }
+    }
+    if (next_edge >= (1u << (32 - kChildShift)))
+        throw std::length_error("Dictionary is too large for Dawg");
+
+    auto packed = std::make_shared<std::vector<std::uint32_t>>(next_edge, 0);
+    for (const std::uint32_t node : order) {
+        const auto &edges = nodes[node].edges;
+        for (std::size_t j = 0; j < edges.size(); ++j) {
+            const auto &[letter, child] = edges[j];
+            std::uint32_t edge = letter | (first_edge[child] << kChildShift);
+            if (nodes[child].final)
+                edge |= kEndOfWordBit;
+            if (j + 1 == edges.size())
+                edge |= kLastEdgeBit;
+            (*packed)[first_edge[node] + j] = edge;
+        }
+    }
+
+    Dawg dawg;
+    dawg.edges_ = packed->data();
+    dawg.edges_count_ = packed->size();
+    dawg.root_ = first_edge[0];
+    dawg.storage_ = std::move(packed);
+    return dawg;
+}
+
+Dawg Dawg::Map(const std::string &path, const Alphabet &alphabet) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        throw std::runtime_error("Can't open dictionary image " + path);
+    struct stat file_stat {};
+    if (::fstat(fd, &file_stat) == -1) {
+        ::close(fd);
+        throw std::runtime_error("Can't stat dictionary image " + path);
+    }
+    const auto size = static_cast<std::size_t>(file_stat.st_size);
+    if (size < sizeof(ImageHeader)) {
+        ::close(fd);
+        throw std::runtime_error("Dictionary image " + path + " is truncated");
+    }
+    void *address = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED)
+        throw std::runtime_error("Can't map dictionary image " + path);
+    std::shared_ptr<const void> mapping(
+        address, [size](const void *mapped) {
+            ::munmap(const_cast<void *>(mapped), size);
+        });
+
+    ImageHeader header;
+    std::memcpy(&header, address, sizeof(header));
+    if (std::memcmp(header.magic, kImageMagic, sizeof(kImageMagic)) != 0)
+        throw std::runtime_error(path + " is not a dictionary image");
+    if (header.version != kImageVersion)
+        throw std::runtime_error("Dictionary image " + path + " has version " +
+                                 std::to_string(header.version) +
+                                 ", expected " + std::to_string(kImageVersion));
+    if (header.letters != static_cast<std::uint32_t>(alphabet.size()))
+        throw std::runtime_error("Dictionary image " + path +
+                                 " is built for another alphabet");
+    if (header.edges_count == 0 ||
+        (size - sizeof(header)) / sizeof(std::uint32_t) < header.edges_count ||
+        header.root >= header.edges_count)
+        throw std::runtime_error("Dictionary image " + path + " is truncated");
+
+    const auto *edges = reinterpret_cast<const std::uint32_t *>(
+        static_cast<const char *>(address) + sizeof(header));
+    // lookups trust the indices, so a corrupt image fails here once instead
+    // of reading out of the mapping later: every child is inside the array
+    // and the run of edges of every node ends inside it
+    if (!(edges[header.edges_count - 1] & kLastEdgeBit))
+        throw std::runtime_error("Dictionary image " + path + " is corrupt");
+    for (std::uint32_t i = 0; i < header.edges_count; ++i) {
+        if ((edges[i] >> kChildShift) >= header.edges_count)
+            throw std::runtime_error("Dictionary image " + path +
+                                     " is corrupt");
+    }
+
+    Dawg dawg;
+    dawg.edges_ = edges;
+    dawg.edges_count_ = header.edges_count;
+    dawg.root_ = header.root;
+    dawg.storage_ = std::move(mapping);
+    return dawg;
+}
+
+void Dawg::Save(const std::string &path, const Alphabet &alphabet) const {
+    ImageHeader header{};
+    std::memcpy(header.magic, kImageMagic, sizeof(kImageMagic));
+    header.version = kImageVersion;
+    header.letters = static_cast<std::uint32_t>(alphabet.size());
+    header.root = root_;
+    header.edges_count = static_cast<std::uint32_t>(edges_count_);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(edges_),
+               edges_count_ * sizeof(std::uint32_t));
+    if (!file)
+        throw std::runtime_error("Can't write dictionary image " + path);
+}
+
+bool Dawg::empty() const { return root_ == 0; }
+
+std::size_t Dawg::size_bytes() const {
+    return edges_count_ * sizeof(std::uint32_t);
+}
+
+std::vector<Word> LoadWordList(const std::string &path,
+                               const Alphabet &alphabet) {
+    std::ifstream file(path);
+    if (!file)
+        throw std::runtime_error("Can't open word list " + path);
+
+    std::vector<Word> words;
+    std::string line;
+    std::u32string decoded;
+    while (std::getline(file, line)) {
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' '))
+            line.pop_back();
+
+        decoded.clear();
+        try {
+            utf8::utf8to32(line.begin(), line.end(),
+                           std::back_inserter(decoded));
+        } catch (const utf8::exception &) {
+            continue;
+        }
+
+        Word word;
+        for (char32_t c : decoded) {
+            if (c == U'Ё' || c == U'ё')
+                c = U'Е';
+            const Letter letter = alphabet.encode(c);
+            if (letter == kInvalidLetter || letter == kBlank) {
+                word.clear();
+                break;
+            }
+            word.push_back(letter & kLetterMask);
+        }
+        if (word.size() > 1)
+            words.push_back(std::move(word));
+    }
+    return words;
+}
+
+} // namespace ScrabbleGame
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "game/Alphabet.hpp"
+
+namespace ScrabbleGame {
+
+/*
+ * @brief dictionary stored as a minimized acyclic automaton (DAWG)
+ *
+ * @notes every node is a run of edges in edges_; an edge packs
+ * - bits 0..5 letter
+ * - bit 6 a word ends on this edge
+ * - bit 7 edge is the last one of its node
+ * - bits 8..31 index of the first edge of the child node, 0 if there is none
+ *
+ * Letters are compared without kBlankFlag, so words with blanks are looked up
+ * by the letters the blanks stand for.
+ *
+ * Edges only refer to each other by index, so the same array is written to
+ * disk as is (see Save) and later queried in place from a read-only mapping
+ * (see Map). Copies of a Dawg share the edges.
+ */
+class Dawg {
+  public:
+    /*
+     * @brief empty dictionary, contains() is always false
+     */
+    Dawg();
+
+    /*
+     * @brief builds minimized automaton from words
+     *
+     * @param {words} words in any order, duplicates are allowed
+     */
+    static Dawg FromWords(std::vector<Word> words);
+
+    /*
+     * @brief maps dictionary image written by Save read-only into memory
+     *
+     * @notes nothing is parsed or copied, pages of the image are shared with
+     * every other process that maps the same file
+     *
+     * @param {alphabet} alphabet the image must have been built for
+     * @throws std::runtime_error if file is not a valid image
+     */
+    static Dawg Map(const std::string &path, const Alphabet &alphabet);
+
+    /*
+     * @brief writes dictionary image, see kImageMagic for layout
+     *
+     * @param {alphabet} alphabet words were encoded in
+     * @throws std::runtime_error if file can't be written
+     */
+    void Save(const std::string &path, const Alphabet &alphabet) const;
+
+    /*
+     * @brief checks if word is in dictionary
+     *
+     * @param {word} any range of Letter
+     */
+    template <typename Letters> bool contains(const Letters &word) const;
+
+    /*
+     * @brief position of a walk over the automaton, letter by letter
+     */
+    struct Cursor {
+        // first edge of the node reached, 0 if no word goes further
+        std::uint32_t node;
+        // letters walked so far form a word
+        bool end_of_word;
+    };
+
+    Cursor root() const { return Cursor{root_, false}; }
+
+    /*
+     * @brief moves cursor by one letter, kBlankFlag is ignored
+     *
+     * @retval {false} no word goes on with letter, cursor is left as is
+     */
+    bool next(Cursor &cursor, Letter letter) const;
+
+    /*
+     * @brief calls f(Letter, Cursor) for every letter some word goes on with,
+     * in order of letter codes
+     */
+    template <typename F> void for_each_next(const Cursor &cursor, F &&f) const;
+
+    bool empty() const;
+
+    /*
+     * @brief memory taken by the automaton
+     */
+    std::size_t size_bytes() const;
+
+    /*
+     * @brief image layout, all numbers are little endian uint32:
+     * magic[2] version letters root edges_count reserved[2] edges[edges_count]
+     */
+    static constexpr char kImageMagic[8] = {'S', 'C', 'R', 'D',
+                                            'A', 'W', 'G', '\0'};
+    static constexpr std::uint32_t kImageVersion = 1;
+
+  private:
+    static constexpr std::uint32_t kLetterBits = 0x3f;
+    static constexpr std::uint32_t kEndOfWordBit = 1u << 6;
+    static constexpr std::uint32_t kLastEdgeBit = 1u << 7;
+    static constexpr int kChildShift = 8;
+
+    struct ImageHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t letters;
+        std::uint32_t root;
+        std::uint32_t edges_count;
+        std::uint32_t reserved[2];
+    };
+
+    // owns memory edges_ point to: a vector or a file mapping
+    std::shared_ptr<const void> storage_;
+    const std::uint32_t *edges_ = nullptr;
+    std::size_t edges_count_ = 0;
+    // index of the first edge of root node, 0 if dictionary is empty
+    std::uint32_t root_ = 0;
+};
+
+/*
+ * @brief non-owning reference to a dictionary shared by all games of one
+ * language, see DictionaryComponent
+ *
+ * @notes empty handle accepts any word; the dictionary must outlive every
+ * game holding a handle to it
+ */
+class DictionaryHandle final {
+  public:
+    DictionaryHandle() = default;
+    explicit DictionaryHandle(const Dawg &dawg) : dawg_(&dawg) {}
+
+    template <typename Letters> bool contains(const Letters &word) const {
+        return dawg_ == nullptr || dawg_->contains(word);
+    }
+
+    /*
+     * @retval {nullptr} any word is accepted, words can't be enumerated
+     */
+    const Dawg *get() const { return dawg_; }
+
+  private:
+    const Dawg *dawg_ = nullptr;
+};
+
+/*
+ * @brief reads UTF-8 word list, one word per line
+ *
+ * @notes case is ignored and 'Ё' is read as 'Е'; words with characters
+ * outside of alphabet and one letter words are skipped
+ */
+std::vector<Word> LoadWordList(const std::string &path,
+                               const Alphabet &alphabet);
+
+inline bool Dawg::next(Cursor &cursor, const Letter letter) const {
+    std::uint32_t node = cursor.node;
+    if (node == 0)
+        return false;
+    const std::uint32_t wanted = letter & kLetterMask;
+    std::uint32_t edge = edges_[node];
+    while ((edge & kLetterBits) != wanted) {
+        if (edge & kLastEdgeBit)
+            return false;
+        edge = edges_[++node];
+    }
+    cursor = Cursor{edge >> kChildShift, (edge & kEndOfWordBit) != 0};
+    return true;
+}
+
+template <typename Letters> bool Dawg::contains(const Letters &word) const {
+    Cursor cursor = root();
+    for (const Letter letter : word) {
+        if (!next(cursor, letter))
+            return false;
+    }
+    return cursor.end_of_word;
+}
+
+template <typename F>
+void Dawg::for_each_next(const Cursor &cursor, F &&f) const {
+    if (cursor.node == 0)
+        return;
+    for (std::uint32_t node = cursor.node;; ++node) {
+        const std::uint32_t edge = edges_[node];
+        f(static_cast<Letter>(edge & kLetterBits),
+          Cursor{edge >> kChildShift, (edge & kEndOfWordBit) != 0});
+        if (edge & kLastEdgeBit)
+            return;
+    }
+}
+
+} // namespace ScrabbleGame
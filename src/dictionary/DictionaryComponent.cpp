@@ -0,0 +1,65 @@
+#include "DictionaryComponent.hpp"
+
+#include <stdexcept>
+
+#include <userver/components/component_config.hpp>
+#include <userver/formats/parse/common_containers.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace ScrabbleGame {
+
+DictionaryComponent::DictionaryComponent(
+    const components::ComponentConfig &config,
+    const components::ComponentContext &context)
+    : components::ComponentBase(config, context) {
+    const auto languages =
+        config["languages"]
+            .As<std::unordered_map<std::string, std::string>>({});
+    for (const auto &[language, path] : languages) {
+        Dawg dictionary = Dawg::Map(path, GetAlphabet(language));
+        // without words hints find no moves and any word is accepted, a
+        // service like that must not start
+        if (dictionary.empty())
+            throw std::runtime_error("Dictionary " + path + " of " +
+                                     language + " has no words");
+        LOG_INFO() << "Mapped dictionary " << path << " of " << language
+                   << ", " << dictionary.size_bytes() << " bytes";
+        dictionaries_.emplace(language, std::move(dictionary));
+    }
+}
+
+DictionaryHandle
+DictionaryComponent::GetDictionary(std::string_view language) const {
+    const auto it = dictionaries_.find(std::string(language));
+    if (it == dictionaries_.end()) {
+        LOG_WARNING() << "No dictionary for " << language
+                      << ", any word is accepted";
+        return DictionaryHandle{};
+    }
+    return DictionaryHandle{it->second};
+}
+
+const Alphabet &DictionaryComponent::GetAlphabet(std::string_view language) {
+    if (language == "ru")
+        return kRussianAlphabet;
+    throw std::runtime_error("Unsupported language " + std::string(language));
+}
+
+yaml_config::Schema DictionaryComponent::GetStaticConfigSchema() {
+    return yaml_config::MergeSchemas<components::ComponentBase>(R"(
+type: object
+description: dictionaries shared by all games
+additionalProperties: false
+properties:
+    languages:
+        type: object
+        description: dictionary image of every language, by language code
+        properties: {}
+        additionalProperties:
+            type: string
+            description: dictionary image built by dictionary-builder
+)");
+}
+
+} // namespace ScrabbleGame
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <userver/components/component_base.hpp>
+#include <userver/yaml_config/schema.hpp>
+
+#include "Dawg.hpp"
+
+using namespace userver;
+
+namespace ScrabbleGame {
+
+/*
+ * @brief owns one immutable dictionary per language, shared by all games
+ *
+ * @notes images are mapped once at startup; games only keep DictionaryHandle,
+ * so memory doesn't grow with the number of rooms
+ */
+class DictionaryComponent final : public components::ComponentBase {
+  public:
+    // name of your component to refer in static config
+    static constexpr std::string_view kName = "dictionary";
+
+    DictionaryComponent(const components::ComponentConfig &config,
+                        const components::ComponentContext &context);
+
+    /*
+     * @brief dictionary of language
+     *
+     * @param {language} language code from static config, e.g. "ru"
+     * @retval {DictionaryHandle{}} no dictionary for language, any word is
+     * accepted
+     */
+    DictionaryHandle GetDictionary(std::string_view language) const;
+
+    /*
+     * @brief alphabet words of language are encoded in
+     *
+     * @throws std::runtime_error if language is not supported
+     */
+    static const Alphabet &GetAlphabet(std::string_view language);
+
+    static yaml_config::Schema GetStaticConfigSchema();
+
+  private:
+    std::unordered_map<std::string, Dawg> dictionaries_;
+};
+
+} // namespace ScrabbleGame
@@ -0,0 +1,40 @@
+#include <exception>
+#include <iostream>
+
+#include "dictionary/Dawg.hpp"
+
+/*
+ * @brief offline builder of dictionary images mapped by the service
+ *
+ * usage: dictionary-builder <words.txt> <image.dawg>
+ */
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        std::cerr << "usage: " << argv[0] << " <words.txt> <image.dawg>\n";
+        return 2;
+    }
+    try {
+        const auto &alphabet = ScrabbleGame::kRussianAlphabet;
+        const auto words = ScrabbleGame::LoadWordList(argv[1], alphabet);
+        if (words.empty()) {
+            std::cerr << argv[1] << " has no words\n";
+            return 1;
+        }
+        const auto dawg = ScrabbleGame::Dawg::FromWords(words);
+        dawg.Save(argv[2], alphabet);
+        // map the image back, so a broken one never gets deployed
+        const auto image = ScrabbleGame::Dawg::Map(argv[2], alphabet);
+        for (const auto &word : words) {
+            if (!image.contains(word)) {
+                std::cerr << argv[2] << " misses words of " << argv[1] << '\n';
+                return 1;
+            }
+        }
+        std::cout << argv[2] << ": " << words.size() << " words, "
+                  << image.size_bytes() << " bytes\n";
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
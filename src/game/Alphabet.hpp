@@ -0,0 +1,173 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace ScrabbleGame {
+
+/*
+ * @brief dense code of a tile inside the engine
+ *
+ * @notes
+ * - kNoLetter is an empty cell
+ * - 1..Alphabet::size() are letters of the alphabet
+ * - kBlank is a blank (joker) that is not assigned to a letter yet, as it
+ *   lies in a bag or in a hand
+ * - a blank placed on board keeps the code of its letter with kBlankFlag set
+ */
+using Letter = std::uint8_t;
+
+inline constexpr Letter kNoLetter = 0;
+inline constexpr Letter kLetterMask = 0x3f;
+inline constexpr Letter kBlank = kLetterMask;
+inline constexpr Letter kBlankFlag = 0x40;
+// returned by Alphabet::encode for characters outside of the alphabet
+inline constexpr Letter kInvalidLetter = 0xff;
+
+// max number of letters in one alphabet, so codes fit into kLetterMask
+inline constexpr int kMaxLetters = kBlank - 1;
+
+/*
+ * @brief letters of a word, blanks placed on board keep kBlankFlag
+ */
+using Word = std::vector<Letter>;
+
+/*
+ * @brief letters of one language and their values
+ *
+ * @notes conversions between Letter and UTF-32 are only needed at the JSON
+ * boundary, inside the engine letters are compared and looked up by code
+ */
+class Alphabet {
+  public:
+    /*
+     * @param {upper} letters in order of their codes, uppercase
+     * @param {lower} same letters lowercase, used for assigned blanks
+     * @param {values} value of every letter, in the same order
+     */
+    template <std::size_t N>
+    constexpr Alphabet(std::u32string_view upper, std::u32string_view lower,
+                       const std::array<int, N> &values)
+        : size_(static_cast<int>(upper.size())), base_(upper[0]) {
+        for (const char32_t c : upper)
+            base_ = c < base_ ? c : base_;
+        for (const char32_t c : lower)
+            base_ = c < base_ ? c : base_;
+        for (int i = 0; i < size_; ++i) {
+            upper_[i + 1] = upper[i];
+            lower_[i + 1] = lower[i];
+            values_[i + 1] = values[i];
+            codes_[upper[i] - base_] = static_cast<Letter>(i + 1);
+            codes_[lower[i] - base_] = static_cast<Letter>(i + 1) | kBlankFlag;
+            upper_utf8_[i + 1] = Utf8::encode(upper[i]);
+            lower_utf8_[i + 1] = Utf8::encode(lower[i]);
+        }
+        upper_utf8_[kBlank] = Utf8::encode(kBlankChar);
+    }
+
+    /*
+     * @brief number of letters, blank excluded
+     */
+    constexpr int size() const { return size_; }
+
+    /*
+     * @brief code of a character received from a client
+     *
+     * @retval {letter} uppercase letter
+     * @retval {letter | kBlankFlag} lowercase letter, i.e. an assigned blank
+     * @retval {kBlank} '*'
+     * @retval {kInvalidLetter} character is not in alphabet
+     */
+    constexpr Letter encode(const char32_t c) const {
+        if (c == kBlankChar)
+            return kBlank;
+        if (c < base_ || c - base_ >= kCodesSpan)
+            return kInvalidLetter;
+        // characters inside the span that are no letters have no code
+        const Letter letter = codes_[c - base_];
+        return letter == kNoLetter ? kInvalidLetter : letter;
+    }
+
+    /*
+     * @brief character of a letter, lowercase for an assigned blank
+     */
+    constexpr char32_t decode(const Letter letter) const {
+        if (letter == kBlank)
+            return kBlankChar;
+        if (letter & kBlankFlag)
+            return lower_[letter & kLetterMask];
+        return upper_[letter & kLetterMask];
+    }
+
+    /*
+     * @brief decode() as UTF-8, encoded once with the alphabet, so writing a
+     * letter to a client allocates nothing
+     */
+    constexpr std::string_view utf8(const Letter letter) const {
+        const Utf8 &text = letter & kBlankFlag
+                               ? lower_utf8_[letter & kLetterMask]
+                               : upper_utf8_[letter & kLetterMask];
+        return {text.bytes.data(), text.size};
+    }
+
+    /*
+     * @brief value of a tile, blanks are worth nothing
+     */
+    constexpr int value(const Letter letter) const {
+        if (letter & kBlankFlag)
+            return 0;
+        return values_[letter & kLetterMask];
+    }
+
+  private:
+    static constexpr char32_t kBlankChar = U'*';
+
+    struct Utf8 {
+        std::array<char, 4> bytes{};
+        std::uint8_t size = 0;
+
+        static constexpr Utf8 encode(const char32_t c) {
+            Utf8 text;
+            const auto put = [&](const std::uint32_t byte) {
+                text.bytes[text.size++] = static_cast<char>(byte);
+            };
+            if (c < 0x80) {
+                put(c);
+            } else if (c < 0x800) {
+                put(0xc0 | (c >> 6));
+                put(0x80 | (c & 0x3f));
+            } else if (c < 0x10000) {
+                put(0xe0 | (c >> 12));
+                put(0x80 | ((c >> 6) & 0x3f));
+                put(0x80 | (c & 0x3f));
+            } else {
+                put(0xf0 | (c >> 18));
+                put(0x80 | ((c >> 12) & 0x3f));
+                put(0x80 | ((c >> 6) & 0x3f));
+                put(0x80 | (c & 0x3f));
+            }
+            return text;
+        }
+    };
+
+    // upper and lower forms of one alphabet must lie within this range
+    static constexpr int kCodesSpan = 256;
+
+    int size_;
+    char32_t base_;
+    std::array<Letter, kCodesSpan> codes_{};
+    std::array<char32_t, kBlank + 1> upper_{};
+    std::array<char32_t, kBlank + 1> lower_{};
+    std::array<int, kBlank + 1> values_{};
+    std::array<Utf8, kBlank + 1> upper_utf8_{};
+    std::array<Utf8, kBlank + 1> lower_utf8_{};
+};
+
+inline constexpr Alphabet kRussianAlphabet{
+    U"АБВГДЕЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ", U"абвгдежзийклмнопрстуфхцчшщъыьэюя",
+    std::array<int, 32>{1, 3, 2, 3, 2, 1, 5, 5, 1, 2, 2, 2, 2, 1, 1, 2,
+                        2, 2, 2, 3, 10, 5, 10, 5, 10, 10, 10, 5, 5, 10, 10, 3}};
+
+} // namespace ScrabbleGame
@@ -0,0 +1,386 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+#include "Alphabet.hpp"
+
+namespace ScrabbleGame {
+
+/*
+ * @brief rule set of a game, chosen when the game is created
+ */
+enum class Variant : std::uint8_t { standard, super, quick };
+
+/*
+ * @brief geometry and tiles of a Variant, known at compile time: boards,
+ * checks and searches are compiled for the sizes of every variant, see
+ * VisitVariant
+ *
+ * @notes kPremiumRows[y][x]: T - word x3, D - word x2, t - letter x3,
+ * d - letter x2
+ */
+template <Variant V> struct Rules;
+
+template <> struct Rules<Variant::standard> {
+    static constexpr std::string_view kName = "standard";
+    static constexpr int kWidth = 15;
+    static constexpr int kHeight = 15;
+    static constexpr int kHandSize = 7;
+    static constexpr int kBagSize = 131;
+    static constexpr int kJokers = 3;
+    static constexpr std::array<std::string_view, kHeight> kPremiumRows{
+        "T..d...T...d..T", ".D...t...t...D.", "..D...d.d...D..",
+        "d..D...d...D..d", "....D.....D....", ".t...t...t...t.",
+        "..d...d.d...d..", "T..d...D...d..T", "..d...d.d...d..",
+        ".t...t...t...t.", "....D.....D....", "d..D...d...D..d",
+        "..D...d.d...D..", ".D...t...t...D.", "T..d...T...d..T"};
+};
+
+// super board: more room and more tiles for long games of many players
+template <> struct Rules<Variant::super> {
+    static constexpr std::string_view kName = "super";
+    static constexpr int kWidth = 21;
+    static constexpr int kHeight = 21;
+    static constexpr int kHandSize = 7;
+    static constexpr int kBagSize = 204;
+    static constexpr int kJokers = 4;
+    static constexpr std::array<std::string_view, kHeight> kPremiumRows{
+        "T...d.....T.....d...T", ".D......t...t......D.",
+        "..D......d.d......D..", "...D..dT.....Td..D...",
+        "d...D.....t.....D...d", ".....D...d.d...D.....",
+        "...d..D.......D..d...", "...T...t.....t...T...",
+        ".t......d...d......t.", "..d..d.........d..d..",
+        "T...t.....D.....t...T", "..d..d.........d..d..",
+        ".t......d...d......t.", "...T...t.....t...T...",
+        "...d..D.......D..d...", ".....D...d.d...D.....",
+        "d...D.....t.....D...d", "...D..dT.....Td..D...",
+        "..D......d.d......D..", ".D......t...t......D.",
+        "T...d.....T.....d...T"};
+};
+
+// quick game: a small board fills up in a few turns
+template <> struct Rules<Variant::quick> {
+    static constexpr std::string_view kName = "quick";
+    static constexpr int kWidth = 11;
+    static constexpr int kHeight = 11;
+    static constexpr int kHandSize = 7;
+    static constexpr int kBagSize = 64;
+    static constexpr int kJokers = 2;
+    static constexpr std::array<std::string_view, kHeight> kPremiumRows{
+        "T.d..D..d.T", ".D..t.t..D.", "d.D..d..D.d", "...t...t...",
+        ".t..d.d..t.", "D.d..D..d.D", ".t..d.d..t.", "...t...t...",
+        "d.D..d..D.d", ".D..t.t..D.", "T.d..D..d.T"};
+};
+
+/*
+ * @brief calls visitor with std::integral_constant<Variant, variant>, so
+ * the code it runs is the one compiled for the rules of variant
+ */
+template <typename Visitor>
+constexpr decltype(auto) VisitVariant(const Variant variant,
+                                      Visitor &&visitor) {
+    switch (variant) {
+    case Variant::super:
+        return visitor(std::integral_constant<Variant, Variant::super>{});
+    case Variant::quick:
+        return visitor(std::integral_constant<Variant, Variant::quick>{});
+    case Variant::standard:
+        break;
+    }
+    return visitor(std::integral_constant<Variant, Variant::standard>{});
+}
+
+/*
+ * @retval {nullopt} no variant has Rules::kName name
+ */
+constexpr std::optional<Variant> VariantFromName(const std::string_view name) {
+    for (const Variant variant :
+         {Variant::standard, Variant::super, Variant::quick}) {
+        if (VisitVariant(variant, [](auto v) {
+                return Rules<decltype(v)::value>::kName;
+            }) == name)
+            return variant;
+    }
+    return std::nullopt;
+}
+
+// longest line of all variants, no move takes more tiles
+inline constexpr int kMaxLineLength = std::max(
+    {Rules<Variant::standard>::kWidth, Rules<Variant::standard>::kHeight,
+     Rules<Variant::super>::kWidth, Rules<Variant::super>::kHeight,
+     Rules<Variant::quick>::kWidth, Rules<Variant::quick>::kHeight});
+
+/*
+ * @brief game board stored as one contiguous fixed-size array of cells
+ *
+ * @notes cells are addressed as (x, y), same as the old board_letters[x][y];
+ * the flat index is x * kHeight + y, so copying a board is one memcpy and
+ * scanning it is a single linear pass. Cells hold one byte Letter codes.
+ * Sizes are constants of the variant, so loops over cells have fixed bounds
+ */
+template <Variant V> class BasicBoard {
+  public:
+    using Cell = Letter;
+
+    static constexpr Variant kVariant = V;
+    static constexpr int kWidth = Rules<V>::kWidth;
+    static constexpr int kHeight = Rules<V>::kHeight;
+    static constexpr int kCells = kWidth * kHeight;
+
+    // value of a cell without a tile
+    static constexpr Cell kEmpty = kNoLetter;
+
+    static constexpr bool in_bounds(const int x, const int y) {
+        return x >= 0 && x < kWidth && y >= 0 && y < kHeight;
+    }
+
+    static constexpr int index(const int x, const int y) {
+        return x * kHeight + y;
+    }
+
+    Cell at(const int x, const int y) const { return cells_[index(x, y)]; }
+
+    bool empty(const int x, const int y) const {
+        return cells_[index(x, y)] == kEmpty;
+    }
+
+    void set(const int x, const int y, const Cell cell) {
+        cells_[index(x, y)] = cell;
+    }
+
+    /*
+     * @brief price of the cell as sent to clients, read from the premium
+     * layout shared by all boards of the variant
+     *
+     * @retval {-1} plain cell
+     * @retval {2, 3} letter x2, x3
+     * @retval {20, 30} word x2, x3
+     */
+    static int price(const int x, const int y);
+
+    const std::array<Cell, kCells> &cells() const { return cells_; }
+
+  private:
+    std::array<Cell, kCells> cells_{};
+};
+
+using Board = BasicBoard<Variant::standard>;
+
+enum class Premium : std::uint8_t {
+    none,
+    double_letter,
+    triple_letter,
+    double_word,
+    triple_word
+};
+
+// multipliers of a premium, indexed by Premium
+inline constexpr std::array<int, 5> kLetterMultiplier{1, 2, 3, 1, 1};
+inline constexpr std::array<int, 5> kWordMultiplier{1, 1, 1, 2, 3};
+inline constexpr std::array<int, 5> kPremiumPrice{-1, 2, 3, 20, 30};
+
+/*
+ * @brief premium squares of the boards of a variant, shared by all games
+ * instead of being stored per GameState
+ *
+ * @notes kPremiumLayout<V>[BasicBoard<V>::index(x, y)]; premiums only apply
+ * to tiles placed by the move being scored
+ */
+template <Variant V>
+inline constexpr std::array<Premium, BasicBoard<V>::kCells> kPremiumLayout =
+    [] {
+        using Board = BasicBoard<V>;
+        std::array<Premium, Board::kCells> layout{};
+        for (int y = 0; y < Board::kHeight; ++y) {
+            for (int x = 0; x < Board::kWidth; ++x) {
+                Premium premium = Premium::none;
+                switch (Rules<V>::kPremiumRows[y][x]) {
+                case 'T':
+                    premium = Premium::triple_word;
+                    break;
+                case 'D':
+                    premium = Premium::double_word;
+                    break;
+                case 't':
+                    premium = Premium::triple_letter;
+                    break;
+                case 'd':
+                    premium = Premium::double_letter;
+                    break;
+                }
+                layout[Board::index(x, y)] = premium;
+            }
+        }
+        return layout;
+    }();
+
+template <Variant V>
+inline int BasicBoard<V>::price(const int x, const int y) {
+    return kPremiumPrice[static_cast<int>(kPremiumLayout<V>[index(x, y)])];
+}
+
+/*
+ * @brief small fixed set of pending tiles laid over a committed board
+ *
+ * @notes tiles of one move are always in one line, so there are never more
+ * than max(kWidth, kHeight) of them and the overlay never allocates
+ */
+template <Variant V> class BasicPlacementOverlay {
+  public:
+    using Board = BasicBoard<V>;
+
+    static constexpr int kMaxTiles =
+        Board::kWidth > Board::kHeight ? Board::kWidth : Board::kHeight;
+
+    /*
+     * @brief adds tile to overlay
+     *
+     * @retval {false} overlay is full
+     */
+    bool add(const int x, const int y, const Board::Cell cell) {
+        if (size_ == kMaxTiles)
+            return false;
+        indexes_[size_] = Board::index(x, y);
+        cells_[size_] = cell;
+        ++size_;
+        return true;
+    }
+
+    /*
+     * @retval {Board::kEmpty} no pending tile at (x, y)
+     */
+    Board::Cell at(const int x, const int y) const {
+        const int index = Board::index(x, y);
+        for (int i = 0; i < size_; ++i) {
+            if (indexes_[i] == index)
+                return cells_[i];
+        }
+        return Board::kEmpty;
+    }
+
+    int size() const { return size_; }
+
+  private:
+    std::array<int, kMaxTiles> indexes_{};
+    std::array<typename Board::Cell, kMaxTiles> cells_{};
+    int size_ = 0;
+};
+
+using PlacementOverlay = BasicPlacementOverlay<Variant::standard>;
+
+/*
+ * @brief read-only view of a committed board with pending tiles on top of it
+ */
+template <Variant V> class BasicBoardView {
+  public:
+    using Board = BasicBoard<V>;
+
+    BasicBoardView(const Board &board,
+                   const BasicPlacementOverlay<V> &overlay)
+        : board_(board), overlay_(overlay) {}
+
+    Board::Cell at(const int x, const int y) const {
+        const typename Board::Cell cell = board_.at(x, y);
+        if (cell != Board::kEmpty)
+            return cell;
+        return overlay_.at(x, y);
+    }
+
+    bool empty(const int x, const int y) const {
+        return at(x, y) == Board::kEmpty;
+    }
+
+  private:
+    const Board &board_;
+    const BasicPlacementOverlay<V> &overlay_;
+};
+
+using BoardView = BasicBoardView<Variant::standard>;
+
+/*
+ * @brief word formed on board: where it starts, which way it goes and how
+ * long it is
+ *
+ * @notes letters are not copied, WordView reads them from the board
+ */
+struct PlacedWord {
+    // coordinates of the first letter
+    int x;
+    int y;
+    // letters go along x if true, along y if false
+    bool horizontal;
+    int length;
+};
+
+/*
+ * @brief letters of a PlacedWord read in place from a BoardView, a range of
+ * Letter that Dawg::contains accepts
+ */
+template <Variant V> class BasicWordView {
+  public:
+    class Iterator {
+      public:
+        using value_type = Letter;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+        Iterator(const BasicBoardView<V> &board, const int x, const int y,
+                 const bool horizontal)
+            : board_(&board), x_(x), y_(y), horizontal_(horizontal) {}
+
+        Letter operator*() const { return board_->at(x_, y_); }
+
+        Iterator &operator++() {
+            if (horizontal_)
+                ++x_;
+            else
+                ++y_;
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        bool operator==(const Iterator &other) const {
+            return x_ == other.x_ && y_ == other.y_;
+        }
+
+      private:
+        const BasicBoardView<V> *board_ = nullptr;
+        int x_ = 0;
+        int y_ = 0;
+        bool horizontal_ = true;
+    };
+
+    BasicWordView(const BasicBoardView<V> &board, const PlacedWord &word)
+        : board_(board), word_(word) {}
+
+    Iterator begin() const {
+        return Iterator(board_, word_.x, word_.y, word_.horizontal);
+    }
+
+    Iterator end() const {
+        if (word_.horizontal)
+            return Iterator(board_, word_.x + word_.length, word_.y, true);
+        return Iterator(board_, word_.x, word_.y + word_.length, false);
+    }
+
+    int size() const { return word_.length; }
+
+  private:
+    const BasicBoardView<V> &board_;
+    const PlacedWord &word_;
+};
+
+using WordView = BasicWordView<Variant::standard>;
+
+} // namespace ScrabbleGame
@@ -0,0 +1,139 @@
+#include "CrossChecks.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace ScrabbleGame {
+
+template <Variant V>
+void BasicCrossChecks<V>::Rebuild(const Board &board, const Dawg *dawg,
+                                  const Alphabet &alphabet) {
+    for (int x = 0; x < Board::kWidth; ++x) {
+        for (int y = 0; y < Board::kHeight; ++y)
+            UpdateCell_(board, dawg, alphabet, x, y);
+    }
+    // the first word goes through the centre
+    const bool board_empty =
+        std::ranges::all_of(board.cells(), [](const Letter cell) {
+            return cell == Board::kEmpty;
+        });
+    if (board_empty)
+        anchors_[Board::index(Board::kWidth / 2, Board::kHeight / 2)] = true;
+}
+
+template <Variant V>
+void BasicCrossChecks<V>::Update(
+    const Board &board, const Dawg *dawg, const Alphabet &alphabet,
+    const std::vector<std::vector<int>> &coordinates) {
+    for (const auto &tile : coordinates)
+        UpdateAround_(board, dawg, alphabet, tile[0], tile[1]);
+}
+
+template <Variant V>
+void BasicCrossChecks<V>::Update(const Board &board, const Dawg *dawg,
+                                 const Alphabet &alphabet,
+                                 const std::span<const int> cells) {
+    for (const int cell : cells)
+        UpdateAround_(board, dawg, alphabet, cell / Board::kHeight,
+                      cell % Board::kHeight);
+}
+
+template <Variant V>
+void BasicCrossChecks<V>::UpdateAround_(const Board &board, const Dawg *dawg,
+                                        const Alphabet &alphabet,
+                                        const int tile_x, const int tile_y) {
+    UpdateCell_(board, dawg, alphabet, tile_x, tile_y);
+    for (const auto &[dx, dy] : {std::pair{1, 0}, std::pair{-1, 0},
+                                 std::pair{0, 1}, std::pair{0, -1}}) {
+        int x = tile_x + dx;
+        int y = tile_y + dy;
+        while (Board::in_bounds(x, y) && !board.empty(x, y)) {
+            x += dx;
+            y += dy;
+        }
+        if (Board::in_bounds(x, y))
+            UpdateCell_(board, dawg, alphabet, x, y);
+    }
+}
+
+template <Variant V>
+void BasicCrossChecks<V>::UpdateCell_(const Board &board, const Dawg *dawg,
+                                      const Alphabet &alphabet, const int x,
+                                      const int y) {
+    const int index = Board::index(x, y);
+    if (!board.empty(x, y)) {
+        allowed_[0][index] = allowed_[1][index] = 0;
+        cross_sum_[0][index] = cross_sum_[1][index] = -1;
+        anchors_[index] = false;
+        return;
+    }
+
+    bool anchor = false;
+    for (const bool horizontal : {false, true}) {
+        // a move along x is checked against the word along y and vice versa
+        const int dx = horizontal ? 0 : 1;
+        const int dy = horizontal ? 1 : 0;
+
+        int start_x = x;
+        int start_y = y;
+        while (Board::in_bounds(start_x - dx, start_y - dy) &&
+               !board.empty(start_x - dx, start_y - dy)) {
+            start_x -= dx;
+            start_y -= dy;
+        }
+        int end_x = x + dx;
+        int end_y = y + dy;
+        while (Board::in_bounds(end_x, end_y) && !board.empty(end_x, end_y)) {
+            end_x += dx;
+            end_y += dy;
+        }
+        if (start_x == x && start_y == y && end_x == x + dx &&
+            end_y == y + dy) {
+            allowed_[horizontal][index] = kAnyLetter;
+            cross_sum_[horizontal][index] = -1;
+            continue;
+        }
+        anchor = true;
+
+        int sum = 0;
+        for (int i = start_x, j = start_y; i != end_x || j != end_y;
+             i += dx, j += dy) {
+            if (i != x || j != y)
+                sum += alphabet.value(board.at(i, j));
+        }
+        cross_sum_[horizontal][index] = static_cast<std::int16_t>(sum);
+
+        if (dawg == nullptr) {
+            allowed_[horizontal][index] = kAnyLetter;
+            continue;
+        }
+        Dawg::Cursor prefix = dawg->root();
+        bool prefix_found = true;
+        for (int i = start_x, j = start_y; (i != x || j != y) && prefix_found;
+             i += dx, j += dy)
+            prefix_found = dawg->next(prefix, board.at(i, j));
+
+        LetterSet allowed = 0;
+        if (prefix_found) {
+            dawg->for_each_next(prefix, [&](const Letter letter,
+                                            Dawg::Cursor cursor) {
+                for (int i = x + dx, j = y + dy; i != end_x || j != end_y;
+                     i += dx, j += dy) {
+                    if (!dawg->next(cursor, board.at(i, j)))
+                        return;
+                }
+                if (cursor.end_of_word)
+                    allowed |= LetterSet{1} << letter;
+            });
+        }
+        allowed_[horizontal][index] = allowed;
+    }
+
+    anchors_[index] = anchor;
+}
+
+template class BasicCrossChecks<Variant::standard>;
+template class BasicCrossChecks<Variant::super>;
+template class BasicCrossChecks<Variant::quick>;
+
+} // namespace ScrabbleGame
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Alphabet.hpp"
+#include "Board.hpp"
+#include "dictionary/Dawg.hpp"
+
+namespace ScrabbleGame {
+
+// bit per letter code, bit kBlank and higher are never set
+using LetterSet = std::uint64_t;
+
+inline constexpr LetterSet kAnyLetter = (LetterSet{1} << kBlank) - 2;
+
+/*
+ * @brief for every empty cell: letters that may be put there without
+ * breaking the perpendicular word, value of that word and whether the cell
+ * is an anchor (a cell a new word has to go through)
+ *
+ * @notes constraints are kept per direction of the move: a move along x is
+ * restricted by words along y and vice versa. Without a dictionary (nullptr
+ * dawg) every letter fits, only anchors and sums are kept. Arrays are sized
+ * for the board of the variant
+ */
+template <Variant V> class BasicCrossChecks {
+  public:
+    using Board = BasicBoard<V>;
+    using LetterSet = ScrabbleGame::LetterSet;
+
+    static constexpr LetterSet kAnyLetter = ScrabbleGame::kAnyLetter;
+
+    /*
+     * @brief letters allowed at (x, y) for a move along x if horizontal
+     *
+     * @retval {0} cell is occupied or nothing fits
+     */
+    LetterSet allowed(const bool horizontal, const int x, const int y) const {
+        return allowed_[horizontal][Board::index(x, y)];
+    }
+
+    /*
+     * @brief value of the letters of the perpendicular word around (x, y),
+     * premiums excluded
+     *
+     * @retval {-1} no perpendicular word is formed at (x, y)
+     */
+    int cross_sum(const bool horizontal, const int x, const int y) const {
+        return cross_sum_[horizontal][Board::index(x, y)];
+    }
+
+    /*
+     * @brief empty cell next to a tile, or the centre of an empty board
+     */
+    bool anchor(const int x, const int y) const {
+        return anchors_[Board::index(x, y)];
+    }
+
+    /*
+     * @brief computes checks of every cell of board
+     */
+    void Rebuild(const Board &board, const Dawg *dawg,
+                 const Alphabet &alphabet);
+
+    /*
+     * @brief recomputes checks of the cells tiles were just put on and of the
+     * empty cells at both ends of every line going through them, the only
+     * cells whose perpendicular words could change
+     *
+     * @param {coordinates} vector{{x,y}, ...} of tiles already set on board
+     */
+    void Update(const Board &board, const Dawg *dawg,
+                const Alphabet &alphabet,
+                const std::vector<std::vector<int>> &coordinates);
+
+    /*
+     * @brief same as above for tiles just set on board or just taken off it
+     *
+     * @param {cells} BasicBoard::index of the tiles
+     */
+    void Update(const Board &board, const Dawg *dawg,
+                const Alphabet &alphabet, std::span<const int> cells);
+
+  private:
+    // [1] for moves along x, [0] for moves along y
+    std::array<std::array<LetterSet, Board::kCells>, 2> allowed_{};
+    std::array<std::array<std::int16_t, Board::kCells>, 2> cross_sum_{};
+    std::array<bool, Board::kCells> anchors_{};
+
+    void UpdateCell_(const Board &board, const Dawg *dawg,
+                     const Alphabet &alphabet, int x, int y);
+
+    /*
+     * @brief UpdateCell_ of the cell of a tile and of the empty cells at
+     * both ends of the lines going through it
+     */
+    void UpdateAround_(const Board &board, const Dawg *dawg,
+                       const Alphabet &alphabet, int x, int y);
+};
+
+// instantiated in CrossChecks.cpp for every variant
+extern template class BasicCrossChecks<Variant::standard>;
+extern template class BasicCrossChecks<Variant::super>;
+extern template class BasicCrossChecks<Variant::quick>;
+
+using CrossChecks = BasicCrossChecks<Variant::standard>;
+
+} // namespace ScrabbleGame
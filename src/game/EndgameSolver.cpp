@@ -0,0 +1,322 @@
+#include "EndgameSolver.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+namespace ScrabbleGame {
+
+namespace {
+
+constexpr int kInfinity = 1 << 20;
+// Entry::depth of a value that was searched to the end of the game
+constexpr std::uint8_t kSolved = 0xff;
+// Entry::best without a move
+constexpr std::uint8_t kNoMove = 0xff;
+
+enum Bound : std::uint8_t { kExact, kLower, kUpper };
+
+/*
+ * @brief random keys of Zobrist hashing, a position is the xor of the keys
+ * of its tiles, of the counts of letters in both hands and of whose move it
+ * is
+ */
+template <Variant V> struct Keys {
+    std::array<std::array<std::uint64_t, 2 * kBlankFlag>,
+               BasicBoard<V>::kCells>
+        cells;
+    // [side][letter][count], count 0 is 0 so empty hands need no keys
+    std::array<std::array<std::array<std::uint64_t, Move::kMaxLength + 1>,
+                          kBlank + 1>,
+               2>
+        hands;
+    std::uint64_t side;
+    std::uint64_t passed;
+};
+
+template <Variant V> const Keys<V> &ZobristKeys() {
+    static const std::unique_ptr<const Keys<V>> keys = [] {
+        // splitmix64, fixed seed so hashes are the same in every process
+        std::uint64_t state = 0x9e3779b97f4a7c15;
+        auto next = [&state] {
+            std::uint64_t z = (state += 0x9e3779b97f4a7c15);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+            return z ^ (z >> 31);
+        };
+        auto keys = std::make_unique<Keys<V>>();
+        for (auto &cell : keys->cells)
+            std::generate(cell.begin(), cell.end(), next);
+        for (auto &hand : keys->hands) {
+            for (auto &letter : hand) {
+                std::generate(letter.begin(), letter.end(), next);
+                letter[0] = 0;
+            }
+        }
+        keys->side = next();
+        keys->passed = next();
+        return keys;
+    }();
+    return *keys;
+}
+
+} // namespace
+
+template <Variant V>
+BasicEndgameSolver<V>::BasicEndgameSolver(const Dawg &dawg,
+                                          const Alphabet &alphabet,
+                                          Options options)
+    : dawg_(dawg), alphabet_(alphabet), options_([&options] {
+          // move indexes are kept in one byte of an Entry
+          options.width = std::clamp<std::size_t>(options.width, 1,
+                                                  kNoMove - 1);
+          return options;
+      }()) {}
+
+template <Variant V>
+EndgameResult
+BasicEndgameSolver<V>::Solve(const Board &board,
+                             const CrossChecks &cross_checks,
+                             const std::vector<Letter> &hand,
+                             const std::vector<Letter> &opponent_hand) {
+    const auto start = std::chrono::steady_clock::now();
+    const Keys<V> &keys = ZobristKeys<V>();
+
+    table_.assign(std::max<std::size_t>(1, options_.table_bytes /
+                                               sizeof(Entry)),
+                  Entry{});
+    hash_ = 0;
+    for (int i = 0; i < Board::kCells; ++i)
+        hash_ ^= keys.cells[i][board.cells()[i]];
+    hands_ = {};
+    hand_sizes_ = {};
+    for (const int side : {0, 1}) {
+        for (const Letter letter : side == 0 ? hand : opponent_hand) {
+            if (letter == kNoLetter ||
+                (letter & ~(kLetterMask | kBlankFlag)) != 0 ||
+                hand_sizes_[side] == Move::kMaxLength)
+                continue;
+            Return_(side, letter);
+        }
+    }
+
+    // every move but a pass takes a tile, two passes in a row end the game
+    const int max_depth = 2 * (hand_sizes_[0] + hand_sizes_[1]) + 2;
+    moves_.resize(max_depth + 1);
+    board_ = board;
+    cross_checks_ = cross_checks;
+    nodes_ = 0;
+    stopped_ = false;
+
+    Result result;
+    for (int depth = 1; depth <= max_depth; ++depth) {
+        bool exact = true;
+        const int spread =
+            Search_(0, depth, -kInfinity, kInfinity, false, exact);
+        if (stopped_)
+            break;
+        result.move = best_;
+        result.spread = spread;
+        result.depth = depth;
+        result.solved = exact;
+        if (exact)
+            break;
+    }
+    if (result.depth == 0) {
+        // not even one move was searched, the best scoring one found till
+        // the deadline is played
+        const std::vector<Move> moves =
+            BasicMoveGenerator<V>(dawg_, alphabet_, board, cross_checks)
+                .Generate(hand, 1, options_.deadline);
+        if (!moves.empty()) {
+            result.move = moves.front();
+            result.spread = moves.front().score;
+        }
+    }
+
+    result.nodes = nodes_;
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (elapsed.count() > 0)
+        result.nodes_per_second = nodes_ / elapsed.count();
+    return result;
+}
+
+template <Variant V>
+int BasicEndgameSolver<V>::Search_(const int ply, const int depth, int alpha,
+                                   const int beta, const bool passed,
+                                   bool &exact) {
+    if ((++nodes_ & 1023) == 0 &&
+        options_.deadline != MoveGenerator::Deadline::max() &&
+        std::chrono::steady_clock::now() >= options_.deadline)
+        stopped_ = true;
+    if (stopped_)
+        return 0;
+
+    const Keys<V> &keys = ZobristKeys<V>();
+    const int side = ply & 1;
+    const std::uint64_t key =
+        hash_ ^ (side ? keys.side : 0) ^ (passed ? keys.passed : 0);
+    Entry &entry = table_[key % table_.size()];
+    std::uint8_t hint = kNoMove;
+    if (entry.key == key) {
+        // the root needs its best move, not just its value
+        if (ply > 0 && entry.depth >= depth &&
+            (entry.bound == kExact ||
+             (entry.bound == kLower && entry.value >= beta) ||
+             (entry.bound == kUpper && entry.value <= alpha))) {
+            if (entry.depth != kSolved)
+                exact = false;
+            return entry.value;
+        }
+        hint = entry.best;
+    }
+    if (depth == 0) {
+        exact = false;
+        return 0;
+    }
+
+    std::array<Letter, Move::kMaxLength> letters;
+    BasicMoveGenerator<V>(dawg_, alphabet_, board_, cross_checks_)
+        .Generate(Letters_(hands_[side], letters), options_.width,
+                  MoveGenerator::Deadline::max(), moves_[ply]);
+    const std::vector<Move> &moves = moves_[ply].moves;
+    // moves are best scoring first, then a pass, then the best move of the
+    // last search of the position goes before all of them
+    const std::size_t pass = moves.size();
+    std::array<std::uint8_t, kNoMove> order;
+    for (std::size_t i = 0; i <= pass; ++i)
+        order[i] = static_cast<std::uint8_t>(i);
+    if (hint <= pass)
+        std::rotate(order.begin(), order.begin() + hint,
+                    order.begin() + hint + 1);
+
+    const int alpha_start = alpha;
+    int best_value = -kInfinity;
+    std::uint8_t best = kNoMove;
+    bool node_exact = true;
+    for (const std::uint8_t i : std::span(order.data(), pass + 1)) {
+        int value;
+        if (i != pass) {
+            value = Play_(ply, depth, alpha, beta, moves[i], node_exact);
+        } else if (passed) {
+            value = HandValue_(hands_[side ^ 1]) - HandValue_(hands_[side]);
+        } else {
+            value = -Search_(ply + 1, depth - 1, -beta, -alpha, true,
+                             node_exact);
+        }
+        if (stopped_)
+            return 0;
+
+        if (value > best_value) {
+            best_value = value;
+            best = i;
+            if (ply == 0)
+                best_ = i == pass ? std::nullopt : std::optional(moves[i]);
+        }
+        alpha = std::max(alpha, value);
+        if (alpha >= beta)
+            break;
+    }
+
+    if (!node_exact)
+        exact = false;
+    if (entry.key != key || entry.depth <= depth || node_exact) {
+        entry.key = key;
+        entry.value = static_cast<std::int16_t>(best_value);
+        entry.depth = node_exact ? kSolved : static_cast<std::uint8_t>(depth);
+        entry.bound = best_value <= alpha_start ? kUpper
+                      : best_value >= beta      ? kLower
+                                                : kExact;
+        entry.best = best;
+    }
+    return best_value;
+}
+
+template <Variant V>
+int BasicEndgameSolver<V>::Play_(const int ply, const int depth,
+                                 const int alpha, const int beta,
+                                 const Move &move, bool &exact) {
+    const Keys<V> &keys = ZobristKeys<V>();
+    const int side = ply & 1;
+
+    std::array<int, Move::kMaxLength> cells;
+    int count = 0;
+    move.for_each_tile([&](const int x, const int y, const Letter tile) {
+        cells[count] = Board::index(x, y);
+        board_.set(x, y, tile);
+        hash_ ^= keys.cells[cells[count++]][tile];
+        Take_(side, tile);
+    });
+    const std::span<const int> placed(cells.data(), count);
+
+    int value = move.score;
+    // the game is over, the checks are not needed
+    const bool over = hand_sizes_[side] == 0;
+    if (over) {
+        value += 2 * HandValue_(hands_[side ^ 1]);
+    } else {
+        cross_checks_.Update(board_, &dawg_, alphabet_, placed);
+        value -= Search_(ply + 1, depth - 1, move.score - beta,
+                         move.score - alpha, false, exact);
+    }
+
+    move.for_each_tile([&](const int x, const int y, const Letter tile) {
+        board_.set(x, y, Board::kEmpty);
+        hash_ ^= keys.cells[Board::index(x, y)][tile];
+        Return_(side, tile);
+    });
+    if (over)
+        return value;
+    // without the first word the centre is the only anchor again
+    if (board_.empty(Board::kWidth / 2, Board::kHeight / 2))
+        cross_checks_.Rebuild(board_, &dawg_, alphabet_);
+    else
+        cross_checks_.Update(board_, &dawg_, alphabet_, placed);
+    return value;
+}
+
+template <Variant V>
+int BasicEndgameSolver<V>::HandValue_(const Hand &hand) const {
+    int value = 0;
+    for (int letter = 1; letter < kBlank; ++letter)
+        value += hand[letter] * alphabet_.value(static_cast<Letter>(letter));
+    return value;
+}
+
+template <Variant V>
+std::span<const Letter> BasicEndgameSolver<V>::Letters_(
+    const Hand &hand, std::array<Letter, Move::kMaxLength> &letters) const {
+    std::size_t size = 0;
+    for (int letter = 1; letter <= kBlank; ++letter) {
+        for (int i = 0; i < hand[letter]; ++i)
+            letters[size++] = static_cast<Letter>(letter);
+    }
+    return {letters.data(), size};
+}
+
+template <Variant V>
+void BasicEndgameSolver<V>::Take_(const int side, const Letter tile) {
+    const Letter letter = (tile & kBlankFlag) ? kBlank : tile;
+    const auto &keys = ZobristKeys<V>().hands[side][letter];
+    hash_ ^= keys[hands_[side][letter]];
+    --hands_[side][letter];
+    hash_ ^= keys[hands_[side][letter]];
+    --hand_sizes_[side];
+}
+
+template <Variant V>
+void BasicEndgameSolver<V>::Return_(const int side, const Letter tile) {
+    const Letter letter = (tile & kBlankFlag) ? kBlank : tile;
+    const auto &keys = ZobristKeys<V>().hands[side][letter];
+    hash_ ^= keys[hands_[side][letter]];
+    ++hands_[side][letter];
+    hash_ ^= keys[hands_[side][letter]];
+    ++hand_sizes_[side];
+}
+
+template class BasicEndgameSolver<Variant::standard>;
+template class BasicEndgameSolver<Variant::super>;
+template class BasicEndgameSolver<Variant::quick>;
+
+} // namespace ScrabbleGame
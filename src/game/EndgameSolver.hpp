@@ -0,0 +1,142 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "Alphabet.hpp"
+#include "Board.hpp"
+#include "CrossChecks.hpp"
+#include "MoveGenerator.hpp"
+#include "dictionary/Dawg.hpp"
+
+namespace ScrabbleGame {
+
+struct EndgameOptions {
+    // number of moves tried in a position, the best scoring ones, a pass is
+    // always tried as well
+    std::size_t width = 16;
+    // memory taken by the transposition table
+    std::size_t table_bytes = std::size_t{16} << 20;
+    // the search stops after it with the result of the last depth that was
+    // searched completely
+    MoveGenerator::Deadline deadline = MoveGenerator::Deadline::max();
+};
+
+struct EndgameResult {
+    // best move of the player to move, nullopt is a pass
+    std::optional<Move> move;
+    // points the player to move gets over the opponent till the end of the
+    // game, values of the hands left at the end included
+    int spread = 0;
+    // the game was searched to its end, else spread is an estimate of depth
+    // moves
+    bool solved = false;
+    // moves searched ahead
+    int depth = 0;
+    std::uint64_t nodes = 0;
+    double nodes_per_second = 0;
+};
+
+/*
+ * @brief plays out a two-player game whose bag is empty: both hands are
+ * known, so the rest of the game is searched with alpha-beta over the moves
+ * of MoveGenerator, iteratively deepened and with a transposition table
+ *
+ * @notes the game ends when a player uses up their hand, that player gets
+ * the value of the opponent's hand and the opponent loses it, or after two
+ * passes in a row, then each player loses the value of their own hand.
+ * Moves are made and unmade on one copy of the board and its checks, in
+ * O(tiles of the move)
+ */
+template <Variant V> class BasicEndgameSolver {
+  public:
+    using Board = BasicBoard<V>;
+    using CrossChecks = BasicCrossChecks<V>;
+    using Options = EndgameOptions;
+    using Result = EndgameResult;
+
+    BasicEndgameSolver(const Dawg &dawg, const Alphabet &alphabet,
+                       Options options);
+
+    /*
+     * @param {cross_checks} checks of board
+     * @param {hand} hand of the player to move, kBlank for blanks
+     * @param {opponent_hand} hand of the other player
+     */
+    Result Solve(const Board &board, const CrossChecks &cross_checks,
+                 const std::vector<Letter> &hand,
+                 const std::vector<Letter> &opponent_hand);
+
+  private:
+    // number of letters of every code in a hand, blanks under kBlank
+    using Hand = std::array<std::uint8_t, kBlank + 1>;
+
+    struct Entry {
+        std::uint64_t key = 0;
+        std::int16_t value = 0;
+        // moves searched below the position, kSolved if to the end
+        std::uint8_t depth = 0;
+        std::uint8_t bound = 0;
+        // index of the best move in the moves of the position, the index
+        // past the last move is a pass
+        std::uint8_t best = 0;
+    };
+
+    const Dawg &dawg_;
+    const Alphabet &alphabet_;
+    const Options options_;
+
+    std::vector<Entry> table_;
+    // position of the node being searched
+    Board board_;
+    CrossChecks cross_checks_;
+    // moves of the nodes on the path to it, by ply
+    std::vector<MoveBuffers> moves_;
+    // [0] hand of the player to move at the root
+    std::array<Hand, 2> hands_{};
+    std::array<int, 2> hand_sizes_{};
+    std::uint64_t hash_ = 0;
+    std::uint64_t nodes_ = 0;
+    bool stopped_ = false;
+    std::optional<Move> best_;
+
+    /*
+     * @brief spread of the player to move, negamax
+     *
+     * @param {exact} set to false if the search stopped at depth anywhere
+     * below, then the value is an estimate
+     */
+    int Search_(int ply, int depth, int alpha, int beta, bool passed,
+                bool &exact);
+
+    /*
+     * @brief spread of the player to move after move, the rest searched
+     * by Search_
+     */
+    int Play_(int ply, int depth, int alpha, int beta, const Move &move,
+              bool &exact);
+
+    int HandValue_(const Hand &hand) const;
+
+    /*
+     * @brief tiles of hand put into letters
+     */
+    std::span<const Letter>
+    Letters_(const Hand &hand,
+             std::array<Letter, Move::kMaxLength> &letters) const;
+    void Take_(int side, Letter letter);
+    void Return_(int side, Letter letter);
+};
+
+// instantiated in EndgameSolver.cpp for every variant
+extern template class BasicEndgameSolver<Variant::standard>;
+extern template class BasicEndgameSolver<Variant::super>;
+extern template class BasicEndgameSolver<Variant::quick>;
+
+using EndgameSolver = BasicEndgameSolver<Variant::standard>;
+
+} // namespace ScrabbleGame
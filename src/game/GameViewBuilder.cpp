@@ -1,12 +1,266 @@
 #include "GameViewBuilder.hpp"
+#include "JsonWriter.hpp"
+#include "utils/utils.hpp"
+#include <userver/formats/json/serialize.hpp>
+#include <userver/formats/json/value_builder.hpp>
 
 namespace ScrabbleGame {
 
-std::string ViewBuilder::json_game_state_for_user(const u_int64_t &user_id,
-                                                  GameState &state) {}
+namespace {
 
-userver::formats::json::Value ViewBuilder::public_state(GameState &state) {}
-userver::formats::json::Value private_state(const u_int64_t &user_id,
-                                            GameState &state) {}
+/*
+ * @brief text of a cell, " " for an empty one
+ */
+std::string_view CellText(const Alphabet &alphabet, const Letter letter) {
+    return letter == kNoLetter ? std::string_view{" "}
+                               : alphabet.utf8(letter);
+}
+
+void WriteHand(JsonWriter &json, const Alphabet &alphabet,
+               const std::span<const Letter> hand) {
+    json.key("hand");
+    json.begin_array();
+    for (const Letter letter : hand)
+        json.string(alphabet.utf8(letter));
+    json.end_array();
+}
+
+} // namespace
+
+std::string ViewBuilder::setup() const {
+    userver::formats::json::ValueBuilder setup;
+
+    const Alphabet &alphabet = game_.alphabet();
+    setup["alphabet"].Resize(alphabet.size());
+    setup["values"].Resize(alphabet.size());
+    for (int i = 0; i < alphabet.size(); ++i) {
+        const Letter letter = static_cast<Letter>(i + 1);
+        setup["alphabet"][i] = LetterToUtf8(alphabet, letter);
+        setup["values"][i] = alphabet.value(letter);
+    }
+
+    const std::vector<int64_t> &players = game_.get_game_state().players;
+    setup["players"].Resize(players.size());
+    for (size_t i = 0; i < players.size(); ++i)
+        setup["players"][i] = players[i];
+
+    game_.visit_board([&]<Variant V>(const BasicBoard<V> &board) {
+        setup["variant"] = std::string(Rules<V>::kName);
+        setup["width"] = board.kWidth;
+        setup["height"] = board.kHeight;
+        setup["prices"].Resize(board.kWidth);
+        for (int x = 0; x < board.kWidth; ++x) {
+            setup["prices"][x].Resize(board.kHeight);
+            for (int y = 0; y < board.kHeight; ++y)
+                setup["prices"][x][y] = board.price(x, y);
+        }
+    });
+
+    userver::formats::json::ValueBuilder json_vb;
+    json_vb["setup"] = setup.ExtractValue();
+    return userver::formats::json::ToStableString(json_vb.ExtractValue());
+}
+
+std::string ViewBuilder::public_state() const {
+    const GameState &state = game_.get_game_state();
+    const Alphabet &alphabet = game_.alphabet();
+    const int cells = game_.visit_board(
+        []<Variant V>(const BasicBoard<V> &) { return BasicBoard<V>::kCells; });
+    // a letter takes 2 bytes of UTF-8, quotes and a comma
+    std::string out;
+    out.reserve(128 + 6 * cells);
+    JsonWriter json(out);
+    json.begin_object();
+    json.key("bag_size");
+    json.number(state.bag.size());
+    json.key("current_player");
+    json.number(state.current_player);
+
+    // the board is as big as the variant of the game says
+    game_.visit_board([&]<Variant V>(const BasicBoard<V> &board) {
+        json.key("letters");
+        json.begin_array();
+        for (int x = 0; x < board.kWidth; ++x) {
+            json.begin_array();
+            for (int y = 0; y < board.kHeight; ++y)
+                json.string(CellText(alphabet, board.at(x, y)));
+            json.end_array();
+        }
+        json.end_array();
+    });
+
+    // ids of the players are in the setup, index matches current_player
+    json.key("scores");
+    json.begin_array();
+    for (const PlayerState &player : state.playersState)
+        json.number(player.score);
+    json.end_array();
+    json.end_object();
+    return out;
+}
+
+std::string ViewBuilder::private_state(const int64_t player_id) const {
+    std::string out;
+    JsonWriter json(out);
+    json.begin_object();
+    WriteHand(json, game_.alphabet(), game_.player_hand(player_id));
+    if (game_.whose_move_id() == player_id) {
+        json.key("pending_score");
+        json.number(game_.get_pending_score());
+    }
+    json.end_object();
+    return out;
+}
+
+std::string ViewBuilder::state_message(const std::uint64_t version,
+                                       const std::string_view public_state,
+                                       const std::string_view private_state) {
+    // keys in the order ToStableString writes them
+    std::string message;
+    if (public_state.empty()) {
+        message = R"({"ongoing":false,"version":)";
+        message += std::to_string(version);
+        message += '}';
+        return message;
+    }
+    message.reserve(64 + public_state.size() + private_state.size());
+    message = R"({"ongoing":true,)";
+    if (!private_state.empty()) {
+        message += R"("private":)";
+        message += private_state;
+        message += ',';
+    }
+    message += R"("public":)";
+    message += public_state;
+    message += R"(,"version":)";
+    message += std::to_string(version);
+    message += '}';
+    return message;
+}
+
+std::string ViewBuilder::delta_message(const std::uint64_t base,
+                                       const std::uint64_t version,
+                                       const std::string_view public_delta,
+                                       const std::string_view private_delta) {
+    std::string message;
+    message.reserve(64 + public_delta.size() + private_delta.size());
+    message = R"({"base":)";
+    message += std::to_string(base);
+    message += R"(,"ongoing":true,)";
+    if (!private_delta.empty()) {
+        message += R"("private":)";
+        message += private_delta;
+        message += ',';
+    }
+    message += R"("public":)";
+    message += public_delta;
+    message += R"(,"version":)";
+    message += std::to_string(version);
+    message += '}';
+    return message;
+}
+
+GameView ViewBuilder::view() const {
+    const GameState &state = game_.get_game_state();
+    GameView view;
+    game_.visit_board([&]<Variant V>(const BasicBoard<V> &board) {
+        view.cells.assign(board.cells().begin(), board.cells().end());
+        view.height = board.kHeight;
+    });
+    view.variant = game_.variant();
+    view.players = state.players;
+    view.current_player = state.current_player;
+    view.bag_size = state.bag.size();
+    view.scores.reserve(state.playersState.size());
+    for (const PlayerState &player : state.playersState)
+        view.scores.push_back(player.score);
+    for (const int64_t player_id : state.players) {
+        const std::span<const Letter> hand = game_.player_hand(player_id);
+        view.hands[player_id].assign(hand.begin(), hand.end());
+    }
+    view.whose_move = game_.whose_move_id();
+    view.pending_score = game_.get_pending_score();
+    return view;
+}
+
+std::string ViewBuilder::public_delta(const GameView &from,
+                                      const GameView &to) const {
+    const Alphabet &alphabet = game_.alphabet();
+    std::string out;
+    JsonWriter json(out);
+    json.begin_object();
+    if (from.bag_size != to.bag_size) {
+        json.key("bag_size");
+        json.number(to.bag_size);
+    }
+
+    // a move changes a few cells, a takeback empties them again
+    bool cells = false;
+    for (size_t i = 0; i < to.cells.size(); ++i) {
+        if (i < from.cells.size() && from.cells[i] == to.cells[i])
+            continue;
+        if (!cells) {
+            json.key("cells");
+            json.begin_array();
+            cells = true;
+        }
+        json.begin_array();
+        json.number(static_cast<int>(i) / to.height);
+        json.number(static_cast<int>(i) % to.height);
+        json.string(CellText(alphabet, to.cells[i]));
+        json.end_array();
+    }
+    if (cells)
+        json.end_array();
+
+    if (from.current_player != to.current_player) {
+        json.key("current_player");
+        json.number(to.current_player);
+    }
+
+    bool scores = false;
+    for (size_t i = 0; i < to.scores.size(); ++i) {
+        if (i < from.scores.size() && from.scores[i] == to.scores[i])
+            continue;
+        if (!scores) {
+            json.key("scores");
+            json.begin_array();
+            scores = true;
+        }
+        json.begin_array();
+        json.number(i);
+        json.number(to.scores[i]);
+        json.end_array();
+    }
+    if (scores)
+        json.end_array();
+    json.end_object();
+    return out;
+}
+
+std::string ViewBuilder::private_delta(const GameView &from,
+                                       const GameView &to,
+                                       const int64_t player_id) const {
+    const auto to_hand = to.hands.find(player_id);
+    const auto from_hand = from.hands.find(player_id);
+    const bool hand = to_hand != to.hands.end() &&
+                      (from_hand == from.hands.end() ||
+                       from_hand->second != to_hand->second);
+    const bool pending = to.whose_move == player_id;
+    if (!hand && !pending)
+        return {};
+
+    std::string out;
+    JsonWriter json(out);
+    json.begin_object();
+    if (hand)
+        WriteHand(json, game_.alphabet(), to_hand->second);
+    if (pending) {
+        json.key("pending_score");
+        json.number(to.pending_score);
+    }
+    json.end_object();
+    return out;
+}
 
 } // namespace ScrabbleGame
@@ -1,17 +1,129 @@
+#pragma once
+
 #include "ScrabbleGame.hpp"
-#include <userver/formats/json/value.hpp>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace ScrabbleGame {
 
+/*
+ * @brief what players see of a game as plain values, kept with a published
+ * state to find out what the next one changed
+ */
+struct GameView {
+    Variant variant = Variant::standard;
+    // cells of the board in the flat order of BasicBoard
+    std::vector<Letter> cells;
+    // kHeight of the board, to get (x, y) of a flat index
+    int height = 0;
+    int current_player = 0;
+    std::size_t bag_size = 0;
+    // ids of GameState::players
+    std::vector<int64_t> players;
+    // by index in players
+    std::vector<int> scores;
+    // by player id
+    std::map<int64_t, std::vector<Letter>> hands;
+    // id of the player to move and the score of the tiles it placed
+    int64_t whose_move = 0;
+    int pending_score = 0;
+};
+
+/*
+ * @brief builds what players see of a game as json
+ *
+ * @notes a setup message is {"setup": {"alphabet", "height", "players",
+ * "prices", "values", "variant", "width"}}: what never changes during a
+ * game, sent once before the first full state of a connection and of a
+ * resync
+ * - alphabet: letters by engine code from 1, values: their values
+ * - players: ids, in the order of current_player and scores
+ * - prices: [x][y], see BasicBoard::price
+ *
+ * a state message is {"ongoing", "private", "public", "version"}:
+ * - public: "letters" [x][y], "scores" by index in players, "current_player"
+ *   and "bag_size", the same for every player, so it is serialized once per
+ *   state version and the string is shared
+ * - private: hand and pending score of one player
+ * state_message only joins the serialized parts, nothing is serialized per
+ * recipient but the private part
+ *
+ * a delta message has "base", the version it applies to, and only what
+ * changed since it:
+ * - public: "cells" [[x, y, letter], ...] changed (" " for a cell emptied by
+ *   a takeback), "scores" [[index, score], ...] changed, "current_player"
+ *   and "bag_size" if changed
+ * - private: "hand" if changed, "pending_score" whenever the player is to
+ *   move, so a private part without it means it is not the player's move
+ *
+ * states and deltas are written by JsonWriter straight into their strings,
+ * keys in the order ToStableString sorts them, letters as the UTF-8 the
+ * alphabet encoded once; only the setup, once per game, goes through a DOM
+ */
 class ViewBuilder {
   public:
-    std::string json_game_state_for_user(const u_int64_t &user_id,
-                                         GameState &state);
+    explicit ViewBuilder(const ScrabbleGame &game) : game_(game) {}
+
+    /*
+     * @brief setup message of the game, the same for its whole life
+     */
+    std::string setup() const;
+
+    /*
+     * @brief serialized public part of the state
+     */
+    std::string public_state() const;
+
+    /*
+     * @brief serialized private part of the state of player_id
+     */
+    std::string private_state(const int64_t player_id) const;
+
+    /*
+     * @brief state message of one player
+     *
+     * @param {public_state} result of public_state(), empty if the game is
+     * not ongoing
+     * @param {private_state} result of private_state(), empty if the
+     * recipient has no seat
+     */
+    static std::string state_message(const std::uint64_t version,
+                                     const std::string_view public_state,
+                                     const std::string_view private_state);
+
+    /*
+     * @brief delta message of one player from base to version
+     *
+     * @param {private_delta} result of private_delta(), empty if nothing
+     * private changed or the recipient has no seat
+     */
+    static std::string delta_message(const std::uint64_t base,
+                                     const std::uint64_t version,
+                                     const std::string_view public_delta,
+                                     const std::string_view private_delta);
+
+    /*
+     * @brief the game as of now, see GameView
+     */
+    GameView view() const;
+
+    /*
+     * @brief serialized public part of the delta between two views
+     */
+    std::string public_delta(const GameView &from, const GameView &to) const;
+
+    /*
+     * @brief serialized private part of the delta of player_id
+     * @retval {""} nothing private changed for player_id
+     */
+    std::string private_delta(const GameView &from, const GameView &to,
+                              const int64_t player_id) const;
 
   private:
-    userver::formats::json::Value public_state(GameState &state);
-    userver::formats::json::Value private_state(const u_int64_t &user_id,
-                                                GameState &state);
+    const ScrabbleGame &game_;
 };
 
 } // namespace ScrabbleGame
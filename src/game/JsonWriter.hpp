@@ -0,0 +1,85 @@
+#pragma once
+
+#include <charconv>
+#include <concepts>
+#include <string>
+#include <string_view>
+
+namespace ScrabbleGame {
+
+/*
+ * @brief writes json straight into a buffer, in the order it is called
+ *
+ * @notes no DOM, no sorting of keys and no escaping: keys are literals and
+ * strings are letters of an alphabet, so writers call keys in the order
+ * ToStableString would write them to keep the output byte for byte the same
+ */
+class JsonWriter {
+  public:
+    /*
+     * @param {out} the json is appended to it
+     */
+    explicit JsonWriter(std::string &out) : out_(out) {}
+
+    void begin_object() {
+        separate_();
+        out_ += '{';
+        comma_ = false;
+    }
+    void end_object() {
+        out_ += '}';
+        comma_ = true;
+    }
+    void begin_array() {
+        separate_();
+        out_ += '[';
+        comma_ = false;
+    }
+    void end_array() {
+        out_ += ']';
+        comma_ = true;
+    }
+
+    /*
+     * @brief key of the next value, it must not need escaping
+     */
+    void key(const std::string_view key) {
+        separate_();
+        out_ += '"';
+        out_ += key;
+        out_ += "\":";
+        comma_ = false;
+    }
+
+    /*
+     * @brief string value, it must not need escaping
+     */
+    void string(const std::string_view value) {
+        separate_();
+        out_ += '"';
+        out_ += value;
+        out_ += '"';
+        comma_ = true;
+    }
+
+    template <std::integral T> void number(const T value) {
+        separate_();
+        char buffer[24];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer),
+                                          value);
+        out_.append(buffer, result.ptr);
+        comma_ = true;
+    }
+
+  private:
+    std::string &out_;
+    // a value was written at this level, the next one needs a comma
+    bool comma_ = false;
+
+    void separate_() {
+        if (comma_)
+            out_ += ',';
+    }
+};
+
+} // namespace ScrabbleGame
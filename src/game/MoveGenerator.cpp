@@ -0,0 +1,538 @@
+#include "MoveGenerator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <tuple>
+
+#include <userver/engine/wait_all_checked.hpp>
+#include <userver/utils/async.hpp>
+
+namespace ScrabbleGame {
+
+std::vector<std::vector<int>> Move::coordinates() const {
+    std::vector<std::vector<int>> coordinates;
+    for_each_tile([&coordinates](const int x, const int y, Letter) {
+        coordinates.push_back({x, y});
+    });
+    return coordinates;
+}
+
+std::vector<Letter> Move::tiles() const {
+    std::vector<Letter> tiles;
+    for_each_tile([&tiles](int, int, const Letter letter) {
+        tiles.push_back(letter);
+    });
+    return tiles;
+}
+
+bool BetterMove(const Move &lhs, const Move &rhs) {
+    if (lhs.score != rhs.score)
+        return lhs.score > rhs.score;
+    return std::make_tuple(!lhs.horizontal, lhs.y, lhs.x, lhs.length,
+                           lhs.letters, lhs.placed) <
+           std::make_tuple(!rhs.horizontal, rhs.y, rhs.x, rhs.length,
+                           rhs.letters, rhs.placed);
+}
+
+namespace {
+
+using Deadline = std::chrono::steady_clock::time_point;
+
+/*
+ * @brief sums of a move being built, see calculate_score_
+ */
+struct Partial {
+    int main_sum = 0;
+    int word_multiplier = 1;
+    // scores of perpendicular words formed by placed tiles
+    int cross_total = 0;
+    int tiles = 0;
+};
+
+using LeftPart = MoveBuffers::LeftPart;
+
+// left parts and anchors of one Generate() call, read by all of its
+// searches
+using Prepared = MoveBuffers;
+
+/*
+ * @brief one worker of a Generate() call: hand left, the move being built
+ * and the best moves found so far
+ */
+template <Variant V> class Search {
+  public:
+    using Board = BasicBoard<V>;
+    using CrossChecks = BasicCrossChecks<V>;
+
+    Search(const Dawg &dawg, const Alphabet &alphabet, const Board &board,
+           const CrossChecks &cross_checks, const std::span<const Letter> hand,
+           const std::size_t limit, const Deadline deadline,
+           std::vector<Move> best = {})
+        : dawg_(dawg), alphabet_(alphabet), board_(board),
+          cross_checks_(cross_checks), limit_(limit), deadline_(deadline),
+          best_(std::move(best)) {
+        for (const Letter letter : hand) {
+            if (letter == kBlank)
+                ++blanks_;
+            else if (letter != kNoLetter && (letter & kLetterMask) < kBlank)
+                ++hand_[letter & kLetterMask];
+            else
+                continue;
+            // no move takes more tiles than that
+            if (++hand_size_ == Move::kMaxLength)
+                break;
+        }
+        hand_blanks_ = blanks_;
+        best_.clear();
+        best_.reserve(limit);
+    }
+
+    /*
+     * @brief enumerates left parts of hand and anchors of board
+     */
+    void Prepare(Prepared &prepared) {
+        prepared.left_parts.clear();
+        prepared.anchors.clear();
+        LeftPart root{};
+        EnumerateLeftParts_(dawg_.root(), root, prepared.left_parts);
+        // moves are ordered by BetterMove, the order of left parts of one
+        // length doesn't matter; std::sort needs no buffer of its own
+        std::sort(prepared.left_parts.begin(), prepared.left_parts.end(),
+                  [](const LeftPart &lhs, const LeftPart &rhs) {
+                      return lhs.length < rhs.length;
+                  });
+
+        for (const bool horizontal : {true, false}) {
+            horizontal_ = horizontal;
+            const int lines = horizontal ? Board::kHeight : Board::kWidth;
+            for (line_ = 0; line_ < lines; ++line_) {
+                for (int pos = 0; pos < length_(); ++pos) {
+                    if (cross_checks_.anchor(x_(pos), y_(pos)))
+                        prepared.anchors.push_back({horizontal, line_, pos});
+                }
+            }
+        }
+    }
+
+    /*
+     * @brief searches anchors of prepared one by one, taking the next one
+     * no search has taken yet from next
+     */
+    void Run(const Prepared &prepared, std::atomic<std::size_t> &next) {
+        left_parts_ = &prepared.left_parts;
+        for (std::size_t i = next.fetch_add(1, std::memory_order_relaxed);
+             i < prepared.anchors.size();
+             i = next.fetch_add(1, std::memory_order_relaxed)) {
+            if (deadline_ != Deadline::max() &&
+                std::chrono::steady_clock::now() >= deadline_)
+                return;
+            horizontal_ = prepared.anchors[i].horizontal;
+            line_ = prepared.anchors[i].line;
+            anchor_ = prepared.anchors[i].pos;
+            Anchor_();
+        }
+    }
+
+    /*
+     * @brief best moves found, in no particular order
+     */
+    std::vector<Move> TakeBest() { return std::move(best_); }
+
+  private:
+    const Dawg &dawg_;
+    const Alphabet &alphabet_;
+    const Board &board_;
+    const CrossChecks &cross_checks_;
+    const std::size_t limit_;
+    const Deadline deadline_;
+
+    // count of every letter left in hand, by code
+    std::array<int, kBlank> hand_{};
+    int blanks_ = 0;
+    int hand_blanks_ = 0;
+    // blanks standing for every letter in the move being built
+    std::array<int, kBlank> blanks_used_{};
+    int hand_size_ = 0;
+
+    bool horizontal_ = true;
+    int line_ = 0;
+    int anchor_ = 0;
+    // first cell of the word along the line
+    int start_ = 0;
+    std::array<Letter, Move::kMaxLength> letters_{};
+    std::uint32_t placed_ = 0;
+
+    // see Prepared
+    const std::vector<LeftPart> *left_parts_ = nullptr;
+
+    // heap with the worst of the best moves on top
+    std::vector<Move> best_;
+
+    int length_() const {
+        return horizontal_ ? Board::kWidth : Board::kHeight;
+    }
+    int x_(const int pos) const { return horizontal_ ? pos : line_; }
+    int y_(const int pos) const { return horizontal_ ? line_ : pos; }
+    bool empty_(const int pos) const {
+        return board_.empty(x_(pos), y_(pos));
+    }
+
+    void Anchor_() {
+        if (anchor_ > 0 && !empty_(anchor_ - 1)) {
+            // left part is made of tiles already on board
+            start_ = anchor_ - 1;
+            while (start_ > 0 && !empty_(start_ - 1))
+                --start_;
+            placed_ = 0;
+            Dawg::Cursor cursor = dawg_.root();
+            Partial partial;
+            bool found = true;
+            for (int pos = start_; pos < anchor_ && found; ++pos) {
+                const Letter letter = board_.at(x_(pos), y_(pos));
+                found = dawg_.next(cursor, letter);
+                letters_[pos - start_] = letter;
+                partial.main_sum += alphabet_.value(letter);
+            }
+            if (found)
+                ExtendRight_(cursor, anchor_, partial);
+            return;
+        }
+
+        // left part from hand may only take free cells that are not
+        // anchors, those moves are found from the other anchor
+        int limit = 0;
+        while (anchor_ - limit - 1 >= 0 &&
+               !cross_checks_.anchor(x_(anchor_ - limit - 1),
+                                     y_(anchor_ - limit - 1)) &&
+               empty_(anchor_ - limit - 1))
+            ++limit;
+        LeftParts_(limit);
+    }
+
+    /*
+     * @brief runs ExtendRight_ from the anchor after every left part that is
+     * not longer than limit and can go on through the anchor
+     */
+    void LeftParts_(const int limit) {
+        const LetterSet allowed =
+            cross_checks_.allowed(horizontal_, x_(anchor_), y_(anchor_));
+        for (const LeftPart &left : *left_parts_) {
+            if (left.length > limit)
+                return;
+            if (!(left.next & left.available & allowed))
+                continue;
+
+            start_ = anchor_ - left.length;
+            placed_ = (1u << left.length) - 1;
+            Partial partial;
+            for (int i = 0; i < left.length; ++i) {
+                const Letter letter = left.letters[i];
+                Take_(letter);
+                letters_[i] = letter;
+                Place_(start_ + i, letter, partial);
+            }
+            ExtendRight_(left.cursor, anchor_, partial);
+            for (int i = 0; i < left.length; ++i)
+                Return_(left.letters[i]);
+        }
+    }
+
+    void EnumerateLeftParts_(const Dawg::Cursor &cursor, LeftPart &left,
+                             std::vector<LeftPart> &left_parts) {
+        left.cursor = cursor;
+        left.next = 0;
+        dawg_.for_each_next(cursor, [&](const Letter letter, const auto &) {
+            left.next |= LetterSet{1} << letter;
+        });
+        left.available = blanks_ > 0 ? kAnyLetter : 0;
+        for (int letter = 1; letter < kBlank; ++letter) {
+            if (hand_[letter] > 0)
+                left.available |= LetterSet{1} << letter;
+        }
+        left_parts.push_back(left);
+
+        // the anchor itself needs a tile too
+        if (left.length + 1 >= hand_size_ ||
+            left.length + 1 >= Move::kMaxLength)
+            return;
+        dawg_.for_each_next(cursor, [&](const Letter letter,
+                                        const Dawg::Cursor &next) {
+            if (!Available_(letter))
+                return;
+            Take_(letter);
+            left.letters[left.length++] = letter;
+            EnumerateLeftParts_(next, left, left_parts);
+            --left.length;
+            Return_(letter);
+        });
+    }
+
+    bool Available_(const Letter letter) const {
+        return hand_[letter] > 0 || blanks_ > 0;
+    }
+
+    /*
+     * @brief takes a tile of letter, a blank only if there is none left
+     */
+    void Take_(const Letter letter) {
+        if (hand_[letter] > 0) {
+            --hand_[letter];
+        } else {
+            --blanks_;
+            ++blanks_used_[letter];
+        }
+    }
+
+    /*
+     * @brief returns the tile the last Take_(letter) took
+     */
+    void Return_(const Letter letter) {
+        if (blanks_used_[letter] > 0) {
+            --blanks_used_[letter];
+            ++blanks_;
+        } else {
+            ++hand_[letter];
+        }
+    }
+
+    void ExtendRight_(const Dawg::Cursor &cursor, const int pos,
+                      const Partial &partial) {
+        if (pos == length_() || empty_(pos)) {
+            if (pos > anchor_ && cursor.end_of_word)
+                Record_(pos, partial);
+            if (pos == length_())
+                return;
+
+            const LetterSet allowed =
+                cross_checks_.allowed(horizontal_, x_(pos), y_(pos));
+            dawg_.for_each_next(cursor, [&](const Letter letter,
+                                            const Dawg::Cursor &next) {
+                if (!(allowed & (LetterSet{1} << letter)))
+                    return;
+                if (!Available_(letter))
+                    return;
+                const std::uint32_t bit = 1u << (pos - start_);
+                Take_(letter);
+                Partial placed = partial;
+                Place_(pos, letter, placed);
+                letters_[pos - start_] = letter;
+                placed_ |= bit;
+                ExtendRight_(next, pos + 1, placed);
+                placed_ &= ~bit;
+                Return_(letter);
+            });
+            return;
+        }
+
+        const Letter letter = board_.at(x_(pos), y_(pos));
+        Dawg::Cursor next = cursor;
+        if (!dawg_.next(next, letter))
+            return;
+        Partial extended = partial;
+        extended.main_sum += alphabet_.value(letter);
+        letters_[pos - start_] = letter;
+        ExtendRight_(next, pos + 1, extended);
+    }
+
+    /*
+     * @brief adds a tile from hand at pos to the sums of the move, as if it
+     * was not a blank, see Record_
+     */
+    void Place_(const int pos, const Letter letter, Partial &partial) const {
+        const int x = x_(pos);
+        const int y = y_(pos);
+        const int premium =
+            static_cast<int>(kPremiumLayout<V>[Board::index(x, y)]);
+        const int value =
+            alphabet_.value(letter) * kLetterMultiplier[premium];
+        partial.main_sum += value;
+        partial.word_multiplier *= kWordMultiplier[premium];
+        const int cross_sum = cross_checks_.cross_sum(horizontal_, x, y);
+        if (cross_sum >= 0)
+            partial.cross_total +=
+                (cross_sum + value) * kWordMultiplier[premium];
+        ++partial.tiles;
+    }
+
+    /*
+     * @brief marks tiles of move that are blanks: of the tiles with the same
+     * letter, those where the letter is worth the least
+     *
+     * @retval {int} points the blanks take from the move
+     */
+    int AssignBlanks_(Move &move, const int word_multiplier) const {
+        int lost = 0;
+        LetterSet done = 0;
+        for (int i = 0; i < move.length; ++i) {
+            const Letter letter = move.letters[i];
+            if (!(move.placed & (1u << i)) || (letter & kBlankFlag) ||
+                blanks_used_[letter] == 0 ||
+                (done & (LetterSet{1} << letter)))
+                continue;
+            done |= LetterSet{1} << letter;
+            for (int blanks = blanks_used_[letter]; blanks > 0; --blanks) {
+                int cheapest = -1;
+                int cheapest_loss = 0;
+                for (int j = i; j < move.length; ++j) {
+                    if (!(move.placed & (1u << j)) ||
+                        move.letters[j] != letter)
+                        continue;
+                    const int loss = Loss_(j, letter, word_multiplier);
+                    if (cheapest == -1 || loss < cheapest_loss) {
+                        cheapest = j;
+                        cheapest_loss = loss;
+                    }
+                }
+                move.letters[cheapest] |= kBlankFlag;
+                lost += cheapest_loss;
+            }
+        }
+        return lost;
+    }
+
+    /*
+     * @brief points a tile of letter at index of the word brings to the
+     * main word and to its perpendicular word
+     */
+    int Loss_(const int index, const Letter letter,
+              const int word_multiplier) const {
+        const int x = x_(start_ + index);
+        const int y = y_(start_ + index);
+        const int premium =
+            static_cast<int>(kPremiumLayout<V>[Board::index(x, y)]);
+        const int value = alphabet_.value(letter) * kLetterMultiplier[premium];
+        int loss = value * word_multiplier;
+        if (cross_checks_.cross_sum(horizontal_, x, y) >= 0)
+            loss += value * kWordMultiplier[premium];
+        return loss;
+    }
+
+    void Record_(const int end, const Partial &partial) {
+        if (!horizontal_ && partial.tiles == 1) {
+            // one tile with a neighbour along x was already found as a
+            // horizontal move with the same words
+            const int pos = start_ + std::countr_zero(placed_);
+            if ((line_ > 0 && !board_.empty(line_ - 1, pos)) ||
+                (line_ + 1 < Board::kWidth && !board_.empty(line_ + 1, pos)))
+                return;
+        }
+
+        int score =
+            partial.main_sum * partial.word_multiplier + partial.cross_total;
+        // blanks only lower the score
+        if (best_.size() == limit_ && score < best_.front().score)
+            return;
+
+        Move move;
+        move.x = x_(start_);
+        move.y = y_(start_);
+        move.horizontal = horizontal_;
+        move.length = end - start_;
+        std::copy_n(letters_.begin(), move.length, move.letters.begin());
+        move.placed = placed_;
+        if (blanks_ != hand_blanks_)
+            score -= AssignBlanks_(move, partial.word_multiplier);
+        move.score = score;
+
+        if (best_.size() < limit_) {
+            best_.push_back(move);
+            std::push_heap(best_.begin(), best_.end(), BetterMove);
+        } else if (BetterMove(move, best_.front())) {
+            std::pop_heap(best_.begin(), best_.end(), BetterMove);
+            best_.back() = move;
+            std::push_heap(best_.begin(), best_.end(), BetterMove);
+        }
+    }
+};
+
+} // namespace
+
+template <Variant V>
+BasicMoveGenerator<V>::BasicMoveGenerator(const Dawg &dawg,
+                                          const Alphabet &alphabet,
+                                          const Board &board,
+                                          const CrossChecks &cross_checks)
+    : dawg_(dawg), alphabet_(alphabet), board_(board),
+      cross_checks_(cross_checks) {}
+
+template <Variant V>
+std::vector<Move>
+BasicMoveGenerator<V>::Generate(const std::vector<Letter> &hand,
+                                const std::size_t limit,
+                                const Deadline deadline) const {
+    MoveBuffers buffers;
+    Generate(hand, limit, deadline, buffers);
+    return std::move(buffers.moves);
+}
+
+template <Variant V>
+void BasicMoveGenerator<V>::Generate(const std::span<const Letter> hand,
+                                     const std::size_t limit,
+                                     const Deadline deadline,
+                                     MoveBuffers &buffers) const {
+    if (limit == 0) {
+        buffers.moves.clear();
+        return;
+    }
+    Search<V> search(dawg_, alphabet_, board_, cross_checks_, hand, limit,
+                     deadline, std::move(buffers.moves));
+    search.Prepare(buffers);
+    std::atomic<std::size_t> next{0};
+    search.Run(buffers, next);
+
+    buffers.moves = search.TakeBest();
+    std::sort(buffers.moves.begin(), buffers.moves.end(), BetterMove);
+}
+
+template <Variant V>
+std::vector<Move> BasicMoveGenerator<V>::Generate(
+    const std::vector<Letter> &hand, const std::size_t limit,
+    const Deadline deadline, userver::engine::TaskProcessor &task_processor,
+    const std::size_t workers) const {
+    if (workers <= 1)
+        return Generate(hand, limit, deadline);
+    if (limit == 0)
+        return {};
+
+    std::vector<Search<V>> searches;
+    searches.reserve(workers);
+    for (std::size_t i = 0; i < workers; ++i)
+        searches.emplace_back(dawg_, alphabet_, board_, cross_checks_, hand,
+                              limit, deadline);
+    Prepared prepared;
+    searches[0].Prepare(prepared);
+
+    // anchors differ a lot in cost, so workers take them one at a time
+    // instead of splitting them up front: whoever is done first takes more
+    std::atomic<std::size_t> next{0};
+    std::vector<userver::engine::TaskWithResult<void>> tasks;
+    tasks.reserve(workers - 1);
+    for (std::size_t i = 1; i < workers; ++i)
+        tasks.push_back(userver::utils::Async(
+            task_processor, "move-generator",
+            [&search = searches[i], &prepared, &next] {
+                search.Run(prepared, next);
+            }));
+    searches[0].Run(prepared, next);
+    userver::engine::WaitAllChecked(tasks);
+
+    // every search keeps the best moves of its anchors, so the best moves
+    // of all of them are among these; BetterMove is a strict order, so they
+    // don't depend on which worker took which anchor
+    std::vector<Move> moves;
+    for (Search<V> &search : searches) {
+        std::vector<Move> best = search.TakeBest();
+        moves.insert(moves.end(), best.begin(), best.end());
+    }
+    const auto last = moves.begin() + std::min(moves.size(), limit);
+    std::partial_sort(moves.begin(), last, moves.end(), BetterMove);
+    moves.erase(last, moves.end());
+    return moves;
+}
+
+template class BasicMoveGenerator<Variant::standard>;
+template class BasicMoveGenerator<Variant::super>;
+template class BasicMoveGenerator<Variant::quick>;
+
+} // namespace ScrabbleGame
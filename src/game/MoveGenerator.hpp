@@ -0,0 +1,164 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <userver/engine/task/task_processor_fwd.hpp>
+
+#include "Alphabet.hpp"
+#include "Board.hpp"
+#include "CrossChecks.hpp"
+#include "dictionary/Dawg.hpp"
+
+namespace ScrabbleGame {
+
+/*
+ * @brief legal placement found by MoveGenerator
+ */
+struct Move {
+    // a move of any variant fits
+    static constexpr int kMaxLength = kMaxLineLength;
+
+    // coordinates of the first letter of the main word
+    int x = 0;
+    int y = 0;
+    // letters go along x if true, along y if false
+    bool horizontal = true;
+    int length = 0;
+    int score = 0;
+    // letters of the main word, placed blanks keep kBlankFlag
+    std::array<Letter, kMaxLength> letters{};
+    // bit i is set if letters[i] is a new tile from the hand
+    std::uint32_t placed = 0;
+
+    /*
+     * @brief coordinates and letters of new tiles, as TryPlaceTiles takes
+     */
+    std::vector<std::vector<int>> coordinates() const;
+    std::vector<Letter> tiles() const;
+
+    /*
+     * @brief calls f(x, y, letter) for every new tile along the word,
+     * nothing is allocated
+     */
+    template <typename F> void for_each_tile(F &&f) const {
+        for (int i = 0; i < length; ++i) {
+            if (placed & (1u << i))
+                f(horizontal ? x + i : x, horizontal ? y : y + i, letters[i]);
+        }
+    }
+};
+
+/*
+ * @brief strict order of moves: higher score first, then by position and
+ * letters, so results never depend on the order moves were found in
+ */
+bool BetterMove(const Move &lhs, const Move &rhs);
+
+/*
+ * @brief storage of a Generate call, kept by a caller that generates moves
+ * over and over so that no call allocates once it grew
+ */
+struct MoveBuffers {
+    /*
+     * @brief word prefix made of hand letters, put right before an anchor
+     */
+    struct LeftPart {
+        Dawg::Cursor cursor;
+        // letters the dictionary goes on with after the prefix
+        LetterSet next;
+        // letters left in hand after the prefix, all if a blank is left
+        LetterSet available;
+        int length;
+        std::array<Letter, Move::kMaxLength> letters;
+    };
+
+    /*
+     * @brief anchor cell of a line, one unit of work of a search
+     */
+    struct Anchor {
+        bool horizontal;
+        int line;
+        int pos;
+    };
+
+    // every left part of hand, shortest first; they don't depend on the
+    // anchor, so they are enumerated once per call
+    std::vector<LeftPart> left_parts;
+    std::vector<Anchor> anchors;
+    // result of the last call, best first
+    std::vector<Move> moves;
+};
+
+/*
+ * @brief enumerates legal moves of a hand, Appel-Jacobson search over the
+ * DAWG: every move is built from an anchor, first its left part from the
+ * hand, then to the right through tiles already on board
+ *
+ * @notes scores are summed while letters are placed, they are equal to what
+ * TryPlaceTiles gives for the same placement. Lines are scanned with the
+ * sizes of the variant as constants
+ */
+template <Variant V> class BasicMoveGenerator {
+  public:
+    using Board = BasicBoard<V>;
+    using CrossChecks = BasicCrossChecks<V>;
+
+    BasicMoveGenerator(const Dawg &dawg, const Alphabet &alphabet,
+                       const Board &board, const CrossChecks &cross_checks);
+
+    using Deadline = std::chrono::steady_clock::time_point;
+
+    /*
+     * @brief best moves of hand, best first
+     *
+     * @param {hand} letters of a hand, kBlank for blanks
+     * @param {limit} max number of moves returned
+     * @param {deadline} the search stops at the first anchor after it and
+     * returns the best moves found so far
+     */
+    std::vector<Move> Generate(const std::vector<Letter> &hand,
+                               std::size_t limit,
+                               Deadline deadline = Deadline::max()) const;
+
+    /*
+     * @brief same moves as Generate above, put into buffers.moves
+     *
+     * @param {buffers} reused from the last call, nothing is allocated
+     * while they are big enough
+     */
+    void Generate(std::span<const Letter> hand, std::size_t limit,
+                  Deadline deadline, MoveBuffers &buffers) const;
+
+    /*
+     * @brief same moves as Generate above, anchors of board are searched by
+     * workers tasks of task_processor, the calling task is one of them
+     *
+     * @param {workers} number of tasks searching at once, 1 searches in the
+     * calling task only
+     * @notes until deadline moves don't depend on workers
+     */
+    std::vector<Move> Generate(const std::vector<Letter> &hand,
+                               std::size_t limit, Deadline deadline,
+                               userver::engine::TaskProcessor &task_processor,
+                               std::size_t workers) const;
+
+  private:
+    const Dawg &dawg_;
+    const Alphabet &alphabet_;
+    const Board &board_;
+    const CrossChecks &cross_checks_;
+};
+
+// instantiated in MoveGenerator.cpp for every variant
+extern template class BasicMoveGenerator<Variant::standard>;
+extern template class BasicMoveGenerator<Variant::super>;
+extern template class BasicMoveGenerator<Variant::quick>;
+
+using MoveGenerator = BasicMoveGenerator<Variant::standard>;
+
+} // namespace ScrabbleGame
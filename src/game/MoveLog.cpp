@@ -0,0 +1,118 @@
+#include "MoveLog.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "MoveGenerator.hpp"
+
+namespace ScrabbleGame {
+
+MoveLog::MoveLog(const std::uint64_t seed) {
+    bytes_.reserve(kHeaderSize);
+    for (std::size_t i = 0; i < kHeaderSize; ++i)
+        bytes_.push_back(static_cast<std::uint8_t>(seed >> (8 * i)));
+}
+
+std::optional<MoveLog>
+MoveLog::FromBytes(std::span<const std::uint8_t> bytes) {
+    if (!Decode_(bytes, nullptr))
+        return std::nullopt;
+    MoveLog log;
+    log.bytes_.assign(bytes.begin(), bytes.end());
+    return log;
+}
+
+void MoveLog::Submit(const int player,
+                     const std::vector<std::vector<int>> &coordinates,
+                     const std::vector<Letter> &tiles) {
+    Head_(LoggedMove::Kind::submit, player);
+    bytes_.push_back(static_cast<std::uint8_t>(tiles.size()));
+    for (std::size_t i = 0; i < tiles.size(); ++i) {
+        bytes_.push_back(static_cast<std::uint8_t>(coordinates[i][0]));
+        bytes_.push_back(static_cast<std::uint8_t>(coordinates[i][1]));
+        bytes_.push_back(tiles[i]);
+    }
+}
+
+void MoveLog::Submit(const int player, const Move &move) {
+    Head_(LoggedMove::Kind::submit, player);
+    bytes_.push_back(static_cast<std::uint8_t>(std::popcount(move.placed)));
+    move.for_each_tile([this](const int x, const int y, const Letter letter) {
+        bytes_.push_back(static_cast<std::uint8_t>(x));
+        bytes_.push_back(static_cast<std::uint8_t>(y));
+        bytes_.push_back(letter);
+    });
+}
+
+void MoveLog::Change(const int player, const std::vector<Letter> &tiles) {
+    Head_(LoggedMove::Kind::change, player);
+    bytes_.push_back(static_cast<std::uint8_t>(tiles.size()));
+    bytes_.insert(bytes_.end(), tiles.begin(), tiles.end());
+}
+
+void MoveLog::Pass(const int player) {
+    Head_(LoggedMove::Kind::pass, player);
+}
+
+void MoveLog::Truncate(const std::size_t size) {
+    bytes_.resize(std::max(size, kHeaderSize));
+}
+
+std::uint64_t MoveLog::seed() const {
+    std::uint64_t seed = 0;
+    for (std::size_t i = 0; i < kHeaderSize; ++i)
+        seed |= std::uint64_t{bytes_[i]} << (8 * i);
+    return seed;
+}
+
+std::vector<LoggedMove> MoveLog::moves() const {
+    std::vector<LoggedMove> moves;
+    Decode_(bytes_, &moves);
+    return moves;
+}
+
+void MoveLog::Head_(const LoggedMove::Kind kind, const int player) {
+    bytes_.push_back(static_cast<std::uint8_t>(kind) |
+                     static_cast<std::uint8_t>(player << 2));
+}
+
+bool MoveLog::Decode_(std::span<const std::uint8_t> bytes,
+                      std::vector<LoggedMove> *moves) {
+    if (bytes.size() < kHeaderSize)
+        return false;
+    std::size_t pos = kHeaderSize;
+    while (pos < bytes.size()) {
+        LoggedMove move{static_cast<LoggedMove::Kind>(bytes[pos] & 3),
+                        bytes[pos] >> 2,
+                        {},
+                        {}};
+        ++pos;
+        switch (move.kind) {
+        case LoggedMove::Kind::submit:
+        case LoggedMove::Kind::change: {
+            if (pos == bytes.size())
+                return false;
+            const std::size_t tiles = bytes[pos++];
+            const std::size_t width =
+                move.kind == LoggedMove::Kind::submit ? 3 : 1;
+            if (bytes.size() - pos < tiles * width)
+                return false;
+            for (std::size_t i = 0; i < tiles; ++i, pos += width) {
+                if (width == 3)
+                    move.coordinates.push_back({bytes[pos], bytes[pos + 1]});
+                move.tiles.push_back(bytes[pos + width - 1]);
+            }
+            break;
+        }
+        case LoggedMove::Kind::pass:
+            break;
+        default:
+            return false;
+        }
+        if (moves != nullptr)
+            moves->push_back(std::move(move));
+    }
+    return true;
+}
+
+} // namespace ScrabbleGame
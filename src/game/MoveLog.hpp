@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "Alphabet.hpp"
+
+namespace ScrabbleGame {
+
+struct Move;
+
+/*
+ * @brief move of a MoveLog
+ */
+struct LoggedMove {
+    enum class Kind : std::uint8_t { submit = 1, change = 2, pass = 3 };
+
+    Kind kind;
+    // index of the player who made the move
+    int player;
+    // submit: vector{{x,y}, ...} of tiles placed, empty otherwise
+    std::vector<std::vector<int>> coordinates;
+    // submit: tiles placed, change: tiles returned to the bag
+    std::vector<Letter> tiles;
+};
+
+/*
+ * @brief record of a game: the seed of its draws and its moves in order, the
+ * game is rebuilt by playing them again, see ScrabbleGame::Replay
+ *
+ * @notes binary layout, all of it bytes:
+ * - seed, 8 bytes little endian
+ * - every move: kind | player << 2, then for submit the number of tiles and
+ *   x, y, letter of every tile, for change the number of tiles and the
+ *   tiles, nothing more for pass
+ */
+class MoveLog {
+  public:
+    // players are kept in 6 bits of a byte
+    static constexpr int kMaxPlayers = 64;
+
+    explicit MoveLog(const std::uint64_t seed = 0);
+
+    /*
+     * @brief log of bytes() of another log
+     * @retval {nullopt} bytes are not a log
+     */
+    static std::optional<MoveLog>
+    FromBytes(std::span<const std::uint8_t> bytes);
+
+    void Submit(const int player,
+                const std::vector<std::vector<int>> &coordinates,
+                const std::vector<Letter> &tiles);
+    void Submit(const int player, const Move &move);
+    void Change(const int player, const std::vector<Letter> &tiles);
+    void Pass(const int player);
+
+    /*
+     * @brief drops the moves logged after bytes().size() was size
+     */
+    void Truncate(const std::size_t size);
+
+    std::uint64_t seed() const;
+
+    /*
+     * @brief moves in the order they were made
+     */
+    std::vector<LoggedMove> moves() const;
+
+    const std::vector<std::uint8_t> &bytes() const { return bytes_; }
+
+  private:
+    static constexpr std::size_t kHeaderSize = 8;
+
+    std::vector<std::uint8_t> bytes_;
+
+    void Head_(const LoggedMove::Kind kind, const int player);
+
+    /*
+     * @brief moves of bytes, to moves if it is not nullptr
+     * @retval {false} bytes are not a log
+     */
+    static bool Decode_(std::span<const std::uint8_t> bytes,
+                        std::vector<LoggedMove> *moves);
+};
+
+} // namespace ScrabbleGame
@@ -1,110 +1,139 @@
 #include "ScrabbleGame.hpp"
 #include "utils/utils.hpp"
+#include <algorithm>
 #include <codecvt>
 #include <cstddef>
 #include <locale>
-#include <optional>
+#include <random>
 #include <string>
-#include <userver/components/component_base.hpp>
-#include <userver/formats/json/value_builder.hpp>
-#include <userver/logging/log.hpp>
-#include <userver/server/handlers/exceptions.hpp>
 
 namespace ScrabbleGame {
 
-Randomizer::Randomizer(const int &bag_size, const int &jokers_num)
-    : bag_size(bag_size), jokers_num(jokers_num), current_max(bag_size) {
-    std::random_device rand_device;
-    mt_random.seed(rand_device());
+Randomizer::Randomizer(const std::uint64_t seed)
+    : seed_(seed), increment_((0xda3e39cb94b95bdbULL << 1) | 1) {
+    next_();
+    state_ += seed;
+    next_();
 }
 
-int Randomizer::random_tile() {
-    std::uniform_int_distribution distribution(0, bag_size - 1);
-    return distribution(mt_random);
+std::uint64_t Randomizer::RandomSeed() {
+    std::random_device rand_device;
+    return (std::uint64_t{rand_device()} << 32) | rand_device();
 }
 
-int Randomizer::random_tile_wo_jokers() {
-    std::uniform_int_distribution distribution(0, bag_size - 1 - jokers_num);
-    return distribution(mt_random);
+std::uint32_t Randomizer::next_() {
+    const std::uint64_t state = state_;
+    state_ = state * 6364136223846793005ULL + increment_;
+    const auto xorshifted =
+        static_cast<std::uint32_t>(((state >> 18) ^ state) >> 27);
+    const auto rotation = static_cast<int>(state >> 59);
+    return (xorshifted >> rotation) | (xorshifted << ((-rotation) & 31));
 }
 
-int Randomizer::decrement_random_tile() {
-    if (current_max <= 0)
-        return -1;
-    current_max--;
-    std::uniform_int_distribution distribution(0, current_max);
-    return distribution(mt_random);
+std::uint32_t Randomizer::below(const std::uint32_t bound) {
+    // Lemire's multiply and shift, retried in the rare biased cases
+    std::uint64_t product = std::uint64_t{next_()} * bound;
+    if (static_cast<std::uint32_t>(product) < bound) {
+        const std::uint32_t threshold = -bound % bound;
+        while (static_cast<std::uint32_t>(product) < threshold)
+            product = std::uint64_t{next_()} * bound;
+    }
+    return static_cast<std::uint32_t>(product >> 32);
 }
 
-ScrabbleGame::ScrabbleGame(
-    std::function<bool(const std::u32string &word)> word_checker,
-    const int &tiles_max, const int &players_num, const int &bag_size,
-    const int &jokers_num, const std::array<char32_t, 128> &default_tiles)
-    : players_max_(players_num),
-      state_(tiles_max, bag_size, jokers_num, default_tiles),
-      word_checker(word_checker) {};
+void Bag::add(const Letter tile, const int count) {
+    counts_[tile] += count;
+    size_ += count;
+}
 
-// TODO: players_num should migrate to GameRoom or not...
-GameState::GameState(const int &tiles_max, const int &bag_size,
-                     const int &jokers_num,
-                     const std::array<char32_t, 128> &default_tiles)
-    : TILES_MAX_IN_HAND(tiles_max),
-      board_letters(
-          15, std::vector<std::optional<char32_t>>(15)) // 15 is board dimension
-      ,
-      board_prices(15, std::vector<int>(15, -1)),
-      randomizer(bag_size, jokers_num) {
-    bag.resize(bag_size);
-    FillBag_(bag_size, jokers_num, default_tiles);
-    // TODO: dimensions of board must be settable
+void Bag::remove(const Letter tile) {
+    if (counts_[tile] == 0)
+        return;
+    --counts_[tile];
+    --size_;
 }
 
-void GameState::FillBag_(const int &bag_size, const int &jokers_num,
-                         const std::array<char32_t, 128> &default_tiles) {
-    if (bag_size == 131 and jokers_num == 3) {
-        for (int i = 0; i < 127; ++i) {
-            bag[i] = default_tiles[i];
-        }
-        for (int i = 0; i < jokers_num; ++i) {
-            bag[128 + i] = '*';
+Letter Bag::draw(Randomizer &randomizer) {
+    if (size_ == 0)
+        return kNoLetter;
+    auto rest = randomizer.below(static_cast<std::uint32_t>(size_));
+    for (std::size_t tile = 0; tile < counts_.size(); ++tile) {
+        if (rest < counts_[tile]) {
+            --counts_[tile];
+            --size_;
+            return static_cast<Letter>(tile);
         }
-        return;
+        rest -= counts_[tile];
     }
+    return kNoLetter;
+}
 
-    for (int i = 0; i < bag_size; ++i) {
-        bag[i] = default_tiles[randomizer.random_tile_wo_jokers()];
-    }
-    for (int i = 0; i < jokers_num; ++i) {
-        bag[bag_size + i] = '*';
+ScrabbleGame::ScrabbleGame(DictionaryHandle dictionary, const int &players_num,
+                           const Variant variant, const std::uint64_t seed,
+                           const std::array<Letter, 128> &default_tiles,
+                           const Alphabet &alphabet)
+    : players_max_(players_num), alphabet_(alphabet),
+      state_(variant, default_tiles, seed), dictionary_(dictionary),
+      table_(VisitVariant(variant,
+                          [](auto v) -> decltype(table_) {
+                              return Table<decltype(v)::value>{};
+                          })),
+      log_(seed) {
+    std::visit(
+        [this](auto &table) {
+            table.cross_checks.Rebuild(table.board, dictionary_.get(),
+                                       alphabet_);
+        },
+        table_);
+}
+
+// TODO: players_num should migrate to GameRoom or not...
+GameState::GameState(const Variant variant,
+                     const std::array<Letter, 128> &default_tiles,
+                     const std::uint64_t seed)
+    : TILES_MAX_IN_HAND(VisitVariant(
+          variant,
+          [](auto v) { return Rules<decltype(v)::value>::kHandSize; })),
+      randomizer(seed) {
+    VisitVariant(variant, [&](auto v) {
+        using VariantRules = Rules<decltype(v)::value>;
+        // undo records keep hands in arrays of that size
+        static_assert(VariantRules::kHandSize <= kMaxLineLength);
+        FillBag_(VariantRules::kBagSize, VariantRules::kJokers,
+                 default_tiles);
+    });
+}
+
+void GameState::FillBag_(const int &bag_size, const int &jokers_num,
+                         const std::array<Letter, 128> &default_tiles) {
+    const int letters_num = std::max(0, bag_size - jokers_num);
+    if (letters_num == static_cast<int>(default_tiles.size())) {
+        for (const Letter tile : default_tiles)
+            bag.add(tile);
+    } else {
+        for (int i = 0; i < letters_num; ++i)
+            bag.add(default_tiles[randomizer.below(default_tiles.size())]);
     }
-    return;
+    bag.add(kBlank, std::max(0, jokers_num));
 }
 
 void GameState::FillHand(const int index) {
     PlayerState &current_player = playersState[index];
 
     while (current_player.hand.size() < TILES_MAX_IN_HAND) {
-        char32_t new_tile = DrawTile_();
-        if (new_tile == 0)
+        Letter new_tile = DrawTile_();
+        if (new_tile == kNoLetter)
             return;
         current_player.hand.push_back(new_tile);
     }
     return;
 }
 
-char32_t GameState::DrawTile_() {
-    if (bag.size() == 0)
-        return 0;
+Letter GameState::DrawTile_() { return bag.draw(randomizer); }
 
-    int rand_int = randomizer.decrement_random_tile();
-    char32_t return_tile = bag[rand_int];
-    bag[rand_int] = bag[bag.size() - 1];
-    bag.pop_back();
-
-    return return_tile;
-}
-
-std::string ScrabbleGame::TilesCheck_() {
+template <Variant V>
+std::string ScrabbleGame::TilesCheck_(const Table<V> &table) {
+    using Board = BasicBoard<V>;
     auto &coordinates = state_.new_tiles_coordinates;
     auto &tiles = state_.new_letters;
 
@@ -114,18 +143,22 @@ std::string ScrabbleGame::TilesCheck_() {
     // Validate every coordinate is well-formed and inside the board before we
     // ever index into the board, so bad client input can't cause out-of-range
     // access (which would be UB / an abort, not a catchable error).
-    const int board_w = static_cast<int>(state_.board_letters.size());
     for (const auto &c : coordinates) {
         if (c.size() < 2)
             return "Malformed coordinate";
-        const int x = c[0];
-        const int y = c[1];
-        if (x < 0 || x >= board_w || y < 0 ||
-            y >= static_cast<int>(state_.board_letters[x].size()))
+        if (!Board::in_bounds(c[0], c[1]))
             return "Coordinates out of board";
     }
 
-    auto new_board = state_.board_letters;
+    if (coordinates.size() > BasicPlacementOverlay<V>::kMaxTiles)
+        return "Too many tiles";
+    for (const Letter tile : tiles) {
+        if (tile == kInvalidLetter || tile == kNoLetter)
+            return "Unknown letter";
+        // a blank on board stands for a letter, sent lowercase
+        if (tile == kBlank)
+            return "Blank has no letter";
+    }
 
     // TODO: to redo from here see todo in declaration
     bool horizontal = true;
@@ -142,139 +175,99 @@ std::string ScrabbleGame::TilesCheck_() {
         return "Tiles are not in line";
     // to here
 
+    // pending tiles are read through an overlay, so the committed board is
+    // never copied while validating
+    BasicPlacementOverlay<V> overlay;
+    const BasicBoardView<V> new_board(table.board, overlay);
     for (size_t i = 0; i < coordinates.size(); i++) {
         const auto &tile_coords = coordinates[i];
 
-        if (new_board[tile_coords[0]][tile_coords[1]])
+        if (!new_board.empty(tile_coords[0], tile_coords[1]))
             return "Coordinates already occupied by another Tile";
 
-        new_board[tile_coords[0]][tile_coords[1]] = tiles[i];
+        overlay.add(tile_coords[0], tile_coords[1], tiles[i]);
     }
 
-    std::vector<std::u32string> words =
-        GetNewWords_(new_board, coordinates, horizontal);
+    // every tile has to be a part of the main word, and one of them has to
+    // be put on an anchor to join the tiles on board
+    const PlacedWord main_word =
+        horizontal ? horizontal_check_(new_board, coordinates[0])
+                   : vertical_check_(new_board, coordinates[0]);
+    bool anchored = false;
+    for (const auto &tile_coords : coordinates) {
+        const int offset = horizontal ? tile_coords[0] - main_word.x
+                                      : tile_coords[1] - main_word.y;
+        if (offset < 0 || offset >= main_word.length)
+            return "Tiles are not connected";
+        if (table.cross_checks.anchor(tile_coords[0], tile_coords[1]))
+            anchored = true;
+    }
+    if (!anchored)
+        return "Tiles are not connected to board";
 
     int score = 0;
-    for (const auto &word : words) {
-        if (!word_checker(word)) {
-            state_.score = -1;
+    int words = 0;
+    // perpendicular words are checked by the letter sets of their cells,
+    // without walking them
+    for (size_t i = 0; i < coordinates.size(); i++) {
+        const int x = coordinates[i][0];
+        const int y = coordinates[i][1];
+        const int cross_sum = table.cross_checks.cross_sum(horizontal, x, y);
+        if (cross_sum < 0)
+            continue;
+        const LetterSet allowed = table.cross_checks.allowed(horizontal, x, y);
+        const Letter letter = tiles[i] & kLetterMask;
+        if (!(allowed & (LetterSet{1} << letter)))
             return "Word does not exist";
-        }
-        score += calculate_score_(word);
+        const int premium =
+            static_cast<int>(kPremiumLayout<V>[Board::index(x, y)]);
+        const int value =
+            alphabet_.value(tiles[i]) * kLetterMultiplier[premium];
+        score += (cross_sum + value) * kWordMultiplier[premium];
+        ++words;
+    }
+
+    if (main_word.length > 1) {
+        if (!dictionary_.contains(BasicWordView<V>(new_board, main_word)))
+            return "Word does not exist";
+        score += calculate_score_(table.board, new_board, main_word);
+        ++words;
     }
+    if (words == 0)
+        return "No word is formed";
 
     state_.score = score;
     return "";
 }
 
-int ScrabbleGame::calculate_score_(const std::u32string &word) const {
+template <Variant V>
+int ScrabbleGame::calculate_score_(const BasicBoard<V> &board,
+                                   const BasicBoardView<V> &new_board_letters,
+                                   const PlacedWord &word) const {
     int score = 0;
-    for (const char32_t &letter : word) {
-        switch (letter) {
-        case U'А':
-            score += 1;
-            break;
-        case U'Б':
-            score += 3;
-            break;
-        case U'В':
-            score += 2;
-            break;
-        case U'Г':
-            score += 3;
-            break;
-        case U'Д':
-            score += 2;
-            break;
-        case U'Е':
-            score += 1;
-            break;
-        case U'Ж':
-            score += 5;
-            break;
-        case U'З':
-            score += 5;
-            break;
-        case U'И':
-            score += 1;
-            break;
-        case U'Й':
-            score += 2;
-            break;
-        case U'К':
-            score += 2;
-            break;
-        case U'Л':
-            score += 2;
-            break;
-        case U'М':
-            score += 2;
-            break;
-        case U'Н':
-            score += 1;
-            break;
-        case U'О':
-            score += 1;
-            break;
-        case U'П':
-            score += 2;
-            break;
-        case U'Р':
-            score += 2;
-            break;
-        case U'С':
-            score += 2;
-            break;
-        case U'Т':
-            score += 2;
-            break;
-        case U'У':
-            score += 3;
-            break;
-        case U'Ф':
-            score += 10;
-            break;
-        case U'Х':
-            score += 5;
-            break;
-        case U'Ц':
-            score += 10;
-            break;
-        case U'Ч':
-            score += 5;
-            break;
-        case U'Ш':
-            score += 10;
-            break;
-        case U'Щ':
-            score += 10;
-            break;
-        case U'Ъ':
-            score += 10;
-            break;
-        case U'Ы':
-            score += 5;
-            break;
-        case U'Ь':
-            score += 5;
-            break;
-        case U'Э':
-            score += 10;
-            break;
-        case U'Ю':
-            score += 10;
-            break;
-        case U'Я':
-            score += 3;
-            break;
+    int word_multiplier = 1;
+    int x = word.x;
+    int y = word.y;
+    for (const Letter letter : BasicWordView<V>(new_board_letters, word)) {
+        int value = alphabet_.value(letter);
+        if (board.empty(x, y)) {
+            const int premium =
+                static_cast<int>(kPremiumLayout<V>[board.index(x, y)]);
+            value *= kLetterMultiplier[premium];
+            word_multiplier *= kWordMultiplier[premium];
         }
+        score += value;
+        if (word.horizontal)
+            ++x;
+        else
+            ++y;
     }
-    return score;
+    return score * word_multiplier;
 }
 
 std::string
 ScrabbleGame::TryPlaceTiles(std::vector<std::vector<int>> &&coordinates,
-                            std::vector<char32_t> &&tiles) {
+                            std::vector<Letter> &&tiles) {
     state_.score = -1;
 
     if (coordinates.size() != tiles.size())
@@ -283,7 +276,8 @@ ScrabbleGame::TryPlaceTiles(std::vector<std::vector<int>> &&coordinates,
     state_.new_tiles_coordinates = std::move(coordinates);
     state_.new_letters = std::move(tiles);
 
-    return TilesCheck_();
+    return std::visit([this](const auto &table) { return TilesCheck_(table); },
+                      table_);
 }
 
 int ScrabbleGame::SubmitWord() {
@@ -292,123 +286,158 @@ int ScrabbleGame::SubmitWord() {
 
     auto &new_tiles = state_.new_letters;
     auto &new_tiles_coordinates = state_.new_tiles_coordinates;
-
-    for (size_t i = 0; i < new_tiles.size(); ++i) {
-        const int &tile_x = new_tiles_coordinates[i][0];
-        const int &tile_y = new_tiles_coordinates[i][1];
-        state_.board_letters[tile_x][tile_y] = new_tiles[i];
-    }
+    UndoRecord record =
+        Remember_(LoggedMove::Kind::submit, state_.current_player);
+
+    std::visit(
+        [&](auto &table) {
+            for (size_t i = 0; i < new_tiles.size(); ++i) {
+                const int &tile_x = new_tiles_coordinates[i][0];
+                const int &tile_y = new_tiles_coordinates[i][1];
+                table.board.set(tile_x, tile_y, new_tiles[i]);
+                record.tiles[record.tiles_size++] =
+                    table.board.index(tile_x, tile_y);
+            }
+            table.cross_checks.Update(
+                table.board, dictionary_.get(), alphabet_,
+                std::span<const int>(record.tiles.data(), record.tiles_size));
+        },
+        table_);
 
     int score = state_.score;
     auto &hand = state_.playersState[state_.current_player].hand;
-    for (const char32_t tile : new_tiles) {
-        auto it = std::find(hand.begin(), hand.end(), tile);
+    for (const Letter tile : new_tiles) {
+        // a placed blank keeps the letter it stands for
+        const Letter hand_tile = (tile & kBlankFlag) ? kBlank : tile;
+        auto it = std::find(hand.begin(), hand.end(), hand_tile);
         if (it != hand.end())
             hand.erase(it);
     }
+    const int kept = static_cast<int>(hand.size());
     state_.FillHand(state_.current_player);
+    record.drawn = static_cast<int>(hand.size()) - kept;
 
     state_.playersState[state_.current_player].score += score;
-    Pass();
+    record.score = score;
+    log_.Submit(state_.current_player, new_tiles_coordinates, new_tiles);
+    Keep_(record);
+    NextTurn_();
     return score;
 }
 
-std::vector<std::u32string> ScrabbleGame::GetNewWords_(
-    std::vector<std::vector<std::optional<char32_t>>> &new_board_letters,
-    std::vector<std::vector<int>> &coordinates, const bool &horizontal) {
-    // TODO: may be better to have possibility to place tiles not in a row
-    std::vector<std::u32string> words;
-    if (horizontal) {
-        // horizontal check
-        {
-            std::u32string word =
-                horizontal_check_(new_board_letters, coordinates[0]);
-            if (word.size() > 1)
-                words.push_back(word);
-        }
-        // vertical checks
-        for (size_t i = 0; i < coordinates.size(); i++) {
-            std::u32string word =
-                vertical_check_(new_board_letters, coordinates[i]);
-            if (word.size() > 1)
-                words.push_back(word);
-        }
-    } else {
-        // horizontal check
-        for (size_t i = 0; i < coordinates.size(); i++) {
-            std::u32string word =
-                horizontal_check_(new_board_letters, coordinates[i]);
-            if (word.size() > 1)
-                words.push_back(word);
-        }
-        // vertical checks
-        {
-            std::u32string word =
-                vertical_check_(new_board_letters, coordinates[0]);
-            if (word.size() > 1)
-                words.push_back(word);
-        }
-    }
-    return words;
+const GameState &ScrabbleGame::get_game_state() const { return state_; }
+
+std::span<const Letter> ScrabbleGame::player_hand(const int64_t id) const {
+    const std::vector<Letter> *hand = hand_(id);
+    if (hand == nullptr)
+        return {};
+    return *hand;
 }
 
-GameState ScrabbleGame::get_game_state() { return state_; }
+std::vector<Move>
+ScrabbleGame::Hint(const int64_t user_id, const std::size_t limit,
+                   const MoveGenerator::Deadline deadline) const {
+    const Dawg *dawg = dictionary_.get();
+    const std::vector<Letter> *hand = hand_(user_id);
+    if (dawg == nullptr || hand == nullptr)
+        return {};
+    return std::visit(
+        [&]<Variant V>(const Table<V> &table) {
+            return BasicMoveGenerator<V>(*dawg, alphabet_, table.board,
+                                         table.cross_checks)
+                .Generate(*hand, limit, deadline);
+        },
+        table_);
+}
 
-std::vector<char32_t> ScrabbleGame::get_player_hand(const int64_t id) {
-    auto it = std::ranges::find(state_.players, id);
-    if (it == state_.players.end())
+std::vector<Move>
+ScrabbleGame::Hint(const int64_t user_id, const std::size_t limit,
+                   const MoveGenerator::Deadline deadline,
+                   userver::engine::TaskProcessor &task_processor,
+                   const std::size_t workers) const {
+    const Dawg *dawg = dictionary_.get();
+    const std::vector<Letter> *hand = hand_(user_id);
+    if (dawg == nullptr || hand == nullptr)
         return {};
-    int idx = std::distance(state_.players.begin(), it);
-    LOG_DEBUG() << "get_player_hand: id=" << id << " idx=" << idx
-                << " players.size()=" << state_.players.size()
-                << " playersState.size()=" << state_.playersState.size();
-    return state_.playersState[idx].hand;
+    return std::visit(
+        [&]<Variant V>(const Table<V> &table) {
+            return BasicMoveGenerator<V>(*dawg, alphabet_, table.board,
+                                         table.cross_checks)
+                .Generate(*hand, limit, deadline, task_processor, workers);
+        },
+        table_);
+}
+
+std::optional<EndgameResult>
+ScrabbleGame::SolveEndgame(const int64_t user_id,
+                           const EndgameOptions &options) const {
+    const Dawg *dawg = dictionary_.get();
+    const std::vector<Letter> *hand = hand_(user_id);
+    if (dawg == nullptr || hand == nullptr || !state_.bag.empty() ||
+        state_.players.size() != 2)
+        return std::nullopt;
+    const int64_t opponent_id = state_.players[0] == user_id
+                                    ? state_.players[1]
+                                    : state_.players[0];
+    return std::visit(
+        [&]<Variant V>(const Table<V> &table) {
+            return BasicEndgameSolver<V>(*dawg, alphabet_, options)
+                .Solve(table.board, table.cross_checks, *hand,
+                       *hand_(opponent_id));
+        },
+        table_);
+}
+
+const std::vector<Letter> *ScrabbleGame::hand_(const int64_t user_id) const {
+    auto it = std::ranges::find(state_.players, user_id);
+    if (it == state_.players.end())
+        return nullptr;
+    return &state_.playersState[std::distance(state_.players.begin(), it)]
+                .hand;
+}
+
+const Alphabet &ScrabbleGame::alphabet() const { return alphabet_; }
+
+Variant ScrabbleGame::variant() const {
+    return std::visit([]<Variant V>(const Table<V> &) { return V; }, table_);
 }
 
-std::u32string ScrabbleGame::horizontal_check_(
-    std::vector<std::vector<std::optional<char32_t>>> &new_board_letters,
-    std::vector<int> &tile_coords) {
-    std::u32string word;
+template <Variant V>
+PlacedWord
+ScrabbleGame::horizontal_check_(const BasicBoardView<V> &new_board_letters,
+                                std::vector<int> &tile_coords) {
     const int &tile_x = tile_coords[0];
     const int &tile_y = tile_coords[1];
 
-    for (int x = tile_x - 1; x >= 0; x--) {
-        if (!new_board_letters[x][tile_y])
-            break;
-        word += *(new_board_letters[x][tile_y]);
-    }
-    word = std::u32string(word.rbegin(), word.rend()) +
-           *(new_board_letters[tile_x][tile_y]);
-    for (size_t x = tile_x + 1; x < new_board_letters.size(); x++) {
-        if (!new_board_letters[x][tile_y])
-            break;
-        word += *(new_board_letters[x][tile_y]);
-    }
+    int start_x = tile_x;
+    while (start_x > 0 && !new_board_letters.empty(start_x - 1, tile_y))
+        start_x--;
+
+    int end_x = tile_x + 1;
+    while (end_x < BasicBoard<V>::kWidth &&
+           !new_board_letters.empty(end_x, tile_y))
+        end_x++;
 
-    return word;
+    return PlacedWord{start_x, tile_y, true, end_x - start_x};
 }
 
-std::u32string ScrabbleGame::vertical_check_(
-    std::vector<std::vector<std::optional<char32_t>>> &new_board_letters,
-    std::vector<int> &tile_coords) {
-    std::u32string word;
+template <Variant V>
+PlacedWord
+ScrabbleGame::vertical_check_(const BasicBoardView<V> &new_board_letters,
+                              std::vector<int> &tile_coords) {
     const int &tile_x = tile_coords[0];
     const int &tile_y = tile_coords[1];
 
-    for (int y = tile_y - 1; y >= 0; y--) {
-        if (!new_board_letters[tile_x][y])
-            break;
-        word += *(new_board_letters[tile_x][y]);
-    }
-    word = std::u32string(word.rbegin(), word.rend()) +
-           *(new_board_letters[tile_x][tile_y]);
-    for (size_t y = tile_y + 1; y < new_board_letters[0].size(); y++) {
-        if (!new_board_letters[tile_x][y])
-            break;
-        word += *(new_board_letters[tile_x][y]);
-    }
+    int start_y = tile_y;
+    while (start_y > 0 && !new_board_letters.empty(tile_x, start_y - 1))
+        start_y--;
 
-    return word;
+    int end_y = tile_y + 1;
+    while (end_y < BasicBoard<V>::kHeight &&
+           !new_board_letters.empty(tile_x, end_y))
+        end_y++;
+
+    return PlacedWord{tile_x, start_y, false, end_y - start_y};
 }
 
 int ScrabbleGame::check_if_player_joined(const int64_t &user_id) {
@@ -419,9 +448,9 @@ int ScrabbleGame::check_if_player_joined(const int64_t &user_id) {
     return std::distance(state_.players.begin(), finder);
 }
 
-int ScrabbleGame::whose_move() { return state_.current_player; }
+int ScrabbleGame::whose_move() const { return state_.current_player; }
 
-int64_t ScrabbleGame::whose_move_id() {
+int64_t ScrabbleGame::whose_move_id() const {
     return state_.players[state_.current_player];
 }
 
@@ -434,6 +463,7 @@ void GameState::init_players(std::vector<int64_t> &&players_) {
 
 int ScrabbleGame::set_players(std::vector<int64_t> players) {
     state_.init_players(std::move(players));
+    history_.reserve(state_.players.size());
     return 0;
 }
 
@@ -441,32 +471,227 @@ int ScrabbleGame::get_players_max() { return players_max_; }
 
 int ScrabbleGame::get_pending_score() const { return state_.score; }
 
-bool ScrabbleGame::Change(const int64_t user_id, std::vector<char32_t> tiles) {
+std::size_t ScrabbleGame::bag_size() const { return state_.bag.size(); }
+
+std::uint64_t ScrabbleGame::seed() const { return state_.seed(); }
+
+const MoveLog &ScrabbleGame::move_log() const { return log_; }
+
+std::optional<ScrabbleGame>
+ScrabbleGame::Replay(DictionaryHandle dictionary,
+                     const std::vector<int64_t> &players, const MoveLog &log,
+                     const Variant variant,
+                     const std::array<Letter, 128> &default_tiles,
+                     const Alphabet &alphabet) {
+    std::optional<ScrabbleGame> game;
+    game.emplace(dictionary, static_cast<int>(players.size()), variant,
+                 log.seed(), default_tiles, alphabet);
+    game->set_players(players);
+    for (const LoggedMove &move : log.moves()) {
+        if (move.player >= static_cast<int>(players.size()))
+            return std::nullopt;
+        switch (move.kind) {
+        case LoggedMove::Kind::submit: {
+            if (move.player != game->whose_move() ||
+                !game->TryPlaceTiles(std::vector(move.coordinates),
+                                     std::vector(move.tiles))
+                     .empty() ||
+                game->SubmitWord() == -1)
+                return std::nullopt;
+            break;
+        }
+        case LoggedMove::Kind::change:
+            if (!game->Change(players[move.player], move.tiles))
+                return std::nullopt;
+            break;
+        case LoggedMove::Kind::pass:
+            if (move.player != game->whose_move())
+                return std::nullopt;
+            game->Pass();
+            break;
+        }
+    }
+    return game;
+}
+
+bool ScrabbleGame::Change(const int64_t user_id, std::vector<Letter> tiles) {
     int idx = check_if_player_joined(user_id);
     if (idx == -1)
         return false;
 
-    auto &hand = state_.playersState[idx].hand;
-
-    for (const char32_t tile : tiles) {
+    if (tiles.size() > state_.playersState[idx].hand.size())
+        return false;
+    if (std::find(tiles.begin(), tiles.end(), kNoLetter) != tiles.end())
+        return false;
+    // nothing is returned unless all tiles are in hand
+    std::vector<Letter> hand = state_.playersState[idx].hand;
+    for (const Letter tile : tiles) {
         auto it = std::find(hand.begin(), hand.end(), tile);
         if (it == hand.end())
             return false;
-        state_.bag.push_back(*it);
         hand.erase(it);
     }
+    UndoRecord record = Remember_(LoggedMove::Kind::change, idx);
+    for (const Letter tile : tiles) {
+        state_.bag.add(tile);
+        record.tiles[record.tiles_size++] = tile;
+    }
+    state_.playersState[idx].hand = std::move(hand);
 
+    const int kept = static_cast<int>(state_.playersState[idx].hand.size());
     state_.FillHand(idx);
-    Pass();
+    record.drawn =
+        static_cast<int>(state_.playersState[idx].hand.size()) - kept;
+    log_.Change(idx, tiles);
+    Keep_(record);
+    NextTurn_();
     return true;
 }
 
 void ScrabbleGame::Pass() {
+    Keep_(Remember_(LoggedMove::Kind::pass, state_.current_player));
+    log_.Pass(state_.current_player);
+    NextTurn_();
+}
+
+int ScrabbleGame::Apply(const Move &move) {
+    const int player = state_.current_player;
+    auto &hand = state_.playersState[player].hand;
+
+    // nothing changes unless every cell is free and every tile is in hand
+    std::array<int, kBlank + 1> left{};
+    for (const Letter tile : hand)
+        ++left[tile & kLetterMask];
+    bool free = move.placed != 0;
+    std::visit(
+        [&]<Variant V>(const Table<V> &table) {
+            move.for_each_tile([&](const int x, const int y,
+                                   const Letter tile) {
+                const Letter hand_tile = (tile & kBlankFlag) ? kBlank : tile;
+                if (!BasicBoard<V>::in_bounds(x, y) ||
+                    !table.board.empty(x, y) ||
+                    --left[hand_tile & kLetterMask] < 0)
+                    free = false;
+            });
+        },
+        table_);
+    if (!free)
+        return -1;
+
+    UndoRecord record = Remember_(LoggedMove::Kind::submit, player);
+    std::visit(
+        [&]<Variant V>(Table<V> &table) {
+            move.for_each_tile([&](const int x, const int y,
+                                   const Letter tile) {
+                table.board.set(x, y, tile);
+                record.tiles[record.tiles_size++] = BasicBoard<V>::index(x, y);
+            });
+            table.cross_checks.Update(
+                table.board, dictionary_.get(), alphabet_,
+                std::span<const int>(record.tiles.data(), record.tiles_size));
+        },
+        table_);
+
+    move.for_each_tile([&hand](int, int, const Letter tile) {
+        const Letter hand_tile = (tile & kBlankFlag) ? kBlank : tile;
+        hand.erase(std::find(hand.begin(), hand.end(), hand_tile));
+    });
+    const int kept = static_cast<int>(hand.size());
+    state_.FillHand(player);
+    record.drawn = static_cast<int>(hand.size()) - kept;
+
+    state_.playersState[player].score += move.score;
+    record.score = move.score;
+    log_.Submit(player, move);
+    Keep_(record);
+    NextTurn_();
+    return move.score;
+}
+
+bool ScrabbleGame::Undo() {
+    if (history_.empty())
+        return false;
+    const UndoRecord &record = history_.back();
+
+    auto &hand = state_.playersState[record.player].hand;
+    for (int i = 0; i < record.drawn; ++i)
+        state_.bag.add(hand[hand.size() - 1 - i]);
+    hand.assign(record.hand.begin(), record.hand.begin() + record.hand_size);
+
+    if (record.kind == LoggedMove::Kind::submit) {
+        std::visit(
+            [&]<Variant V>(Table<V> &table) {
+                using Board = BasicBoard<V>;
+                for (int i = 0; i < record.tiles_size; ++i)
+                    table.board.set(record.tiles[i] / Board::kHeight,
+                                    record.tiles[i] % Board::kHeight,
+                                    Board::kEmpty);
+                // the first word covers the centre, without it the board is
+                // empty and the centre is the only anchor again
+                if (table.board.empty(Board::kWidth / 2, Board::kHeight / 2))
+                    table.cross_checks.Rebuild(table.board, dictionary_.get(),
+                                               alphabet_);
+                else
+                    table.cross_checks.Update(
+                        table.board, dictionary_.get(), alphabet_,
+                        std::span<const int>(record.tiles.data(),
+                                             record.tiles_size));
+            },
+            table_);
+        state_.playersState[record.player].score -= record.score;
+    } else if (record.kind == LoggedMove::Kind::change) {
+        for (int i = 0; i < record.tiles_size; ++i)
+            state_.bag.remove(static_cast<Letter>(record.tiles[i]));
+    }
+
+    state_.randomizer = record.randomizer;
+    log_.Truncate(record.log_size);
+    ClearPending_();
+    state_.current_player = record.turn;
+    history_.pop_back();
+    return true;
+}
+
+int ScrabbleGame::undo_depth(const int player) const {
+    for (std::size_t depth = 1; depth <= history_.size(); ++depth) {
+        if (history_[history_.size() - depth].player == player)
+            return static_cast<int>(depth);
+    }
+    return -1;
+}
+
+ScrabbleGame::UndoRecord
+ScrabbleGame::Remember_(const LoggedMove::Kind kind,
+                        const int player) const {
+    const auto &hand = state_.playersState[player].hand;
+    UndoRecord record{.kind = kind,
+                      .player = player,
+                      .turn = state_.current_player,
+                      .hand_size = static_cast<int>(hand.size()),
+                      .randomizer = state_.randomizer,
+                      .log_size = log_.bytes().size()};
+    std::ranges::copy(hand, record.hand.begin());
+    return record;
+}
+
+void ScrabbleGame::Keep_(const UndoRecord &record) {
+    // a takeback reaches back to the last move of a player, the moves
+    // before the last round are never reverted
+    if (!history_.empty() && history_.size() >= state_.players.size())
+        history_.erase(history_.begin());
+    history_.push_back(record);
+}
+
+void ScrabbleGame::NextTurn_() {
+    ClearPending_();
+    state_.current_player =
+        (state_.current_player + 1) % static_cast<int>(state_.players.size());
+}
+
+void ScrabbleGame::ClearPending_() {
     state_.new_tiles_coordinates.clear();
     state_.new_letters.clear();
     state_.score = -1;
-    state_.current_player =
-        (state_.current_player + 1) % static_cast<int>(state_.players.size());
 }
 
 #ifdef DEBUG
@@ -479,18 +704,19 @@ void ScrabbleGame::draw() {
         std::cout << utf8;
     };
 
-    const auto &board = state_.board_letters;
-    for (size_t x = 0; x < board.size(); ++x) {
-        for (size_t y = 0; y < board[0].size(); ++y) {
-            if (!board[x][y]) {
-                std::cout << "* ";
-            } else {
-                print_char32(*(board[x][y]));
-                std::cout << ' ';
+    visit_board([&]<Variant V>(const BasicBoard<V> &board) {
+        for (int x = 0; x < board.kWidth; ++x) {
+            for (int y = 0; y < board.kHeight; ++y) {
+                if (board.empty(x, y)) {
+                    std::cout << "* ";
+                } else {
+                    print_char32(alphabet_.decode(board.at(x, y)));
+                    std::cout << ' ';
+                }
             }
+            std::cout << '\n';
         }
-        std::cout << '\n';
-    }
+    });
 }
 #endif
 
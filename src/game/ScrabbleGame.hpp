@@ -1,95 +1,127 @@
 #pragma once
 
-#include <userver/engine/condition_variable.hpp>
-#include <userver/formats/json/value.hpp>
-#include <userver/formats/serialize/to.hpp>
 #ifdef DEBUG
 #include <iostream>
 #endif
 
-// #include <unordered_map>
-// #include <map>
-// #include <algorithm>
-// #include <numeric>
 #include <array>
-#include <functional>
+#include <cstdint>
 #include <optional>
-#include <random>
+#include <span>
 #include <string>
+#include <variant>
 #include <vector>
 
-#include <userver/components/component_base.hpp>
-#include <userver/engine/async.hpp>
-#include <userver/engine/mutex.hpp>
-#include <userver/engine/shared_mutex.hpp>
-#include <userver/formats/json.hpp>
+#include "Alphabet.hpp"
+#include "Board.hpp"
+#include "EndgameSolver.hpp"
+#include "MoveGenerator.hpp"
+#include "MoveLog.hpp"
+#include "dictionary/Dawg.hpp"
 
 namespace ScrabbleGame {
 
 struct Tile {
-    char32_t letter;
+    Letter letter;
     int points;
 };
 
 } // namespace ScrabbleGame
 
-constexpr std::array<char32_t, 128> defaultTiles{
-    {U'А', U'А', U'А', U'А', U'А', U'А', U'А', U'А', U'А', U'А', U'Б', U'Б',
-     U'Б', U'В', U'В', U'В', U'В', U'В', U'Г', U'Г', U'Г', U'Д', U'Д', U'Д',
-     U'Д', U'Д', U'Е', U'Е', U'Е', U'Е', U'Е', U'Е', U'Е', U'Е', U'Е', U'Ж',
-     U'Ж', U'З', U'З', U'И', U'И', U'И', U'И', U'И', U'И', U'И', U'И', U'Й',
-     U'Й', U'Й', U'Й', U'К', U'К', U'К', U'К', U'К', U'К', U'Л', U'Л', U'Л',
-     U'Л', U'М', U'М', U'М', U'М', U'М', U'Н', U'Н', U'Н', U'Н', U'Н', U'Н',
-     U'Н', U'Н', U'О', U'О', U'О', U'О', U'О', U'О', U'О', U'О', U'О', U'О',
-     U'П', U'П', U'П', U'П', U'П', U'П', U'Р', U'Р', U'Р', U'Р', U'Р', U'Р',
-     U'С', U'С', U'С', U'С', U'С', U'С', U'Т', U'Т', U'Т', U'Т', U'Т', U'У',
-     U'У', U'У', U'Ф', U'Х', U'Х', U'Ц', U'Ч', U'Ч', U'Ш', U'Щ', U'Ъ', U'Ы',
-     U'Ы', U'Ь', U'Ь', U'Э', U'Ю', U'Я', U'Я', U'Я'}};
+// letters of the default bag, encoded with kRussianAlphabet at compile time
+constexpr std::array<ScrabbleGame::Letter, 128> defaultTiles = [] {
+    constexpr std::array<char32_t, 128> tiles{
+        {U'А', U'А', U'А', U'А', U'А', U'А', U'А', U'А', U'А', U'А', U'Б', U'Б',
+         U'Б', U'В', U'В', U'В', U'В', U'В', U'Г', U'Г', U'Г', U'Д', U'Д', U'Д',
+         U'Д', U'Д', U'Е', U'Е', U'Е', U'Е', U'Е', U'Е', U'Е', U'Е', U'Е', U'Ж',
+         U'Ж', U'З', U'З', U'И', U'И', U'И', U'И', U'И', U'И', U'И', U'И', U'Й',
+         U'Й', U'Й', U'Й', U'К', U'К', U'К', U'К', U'К', U'К', U'Л', U'Л', U'Л',
+         U'Л', U'М', U'М', U'М', U'М', U'М', U'Н', U'Н', U'Н', U'Н', U'Н', U'Н',
+         U'Н', U'Н', U'О', U'О', U'О', U'О', U'О', U'О', U'О', U'О', U'О', U'О',
+         U'П', U'П', U'П', U'П', U'П', U'П', U'Р', U'Р', U'Р', U'Р', U'Р', U'Р',
+         U'С', U'С', U'С', U'С', U'С', U'С', U'Т', U'Т', U'Т', U'Т', U'Т', U'У',
+         U'У', U'У', U'Ф', U'Х', U'Х', U'Ц', U'Ч', U'Ч', U'Ш', U'Щ', U'Ъ', U'Ы',
+         U'Ы', U'Ь', U'Ь', U'Э', U'Ю', U'Я', U'Я', U'Я'}};
+    std::array<ScrabbleGame::Letter, 128> letters{};
+    for (size_t i = 0; i < tiles.size(); ++i)
+        letters[i] = ScrabbleGame::kRussianAlphabet.encode(tiles[i]);
+    return letters;
+}();
 
 namespace ScrabbleGame {
 
 struct PlayerState {
-    std::vector<char32_t> hand;
+    std::vector<Letter> hand;
     int score = 0;
 };
 
+/*
+ * @brief random numbers of a game, PCG32: the whole state is two words and
+ * the same seed always gives the same numbers, so a game can be replayed
+ * from its seed
+ */
 class Randomizer {
-    const int bag_size;
-    const int jokers_num;
-    int current_max;
-
-    std::mt19937 mt_random;
-
   public:
-    Randomizer(const int &bag_size, const int &jokers_num);
+    explicit Randomizer(const std::uint64_t seed);
 
     /*
-     * @brief returns random number [0, bag_size)
+     * @brief seed from std::random_device, for games that are not replayed
      */
-    int random_tile();
+    static std::uint64_t RandomSeed();
+
+    std::uint64_t seed() const { return seed_; }
+
     /*
-     * @brief return random number [0, bag_size-jokers_num)
+     * @brief returns random number [0, bound), bound must be > 0
      */
-    int random_tile_wo_jokers();
+    std::uint32_t below(const std::uint32_t bound);
+
+  private:
+    std::uint64_t seed_;
+    std::uint64_t state_ = 0;
+    std::uint64_t increment_;
+
+    std::uint32_t next_();
+};
+
+/*
+ * @brief tiles in bag, counted per letter code, kBlank for blanks
+ *
+ * @notes the order of tiles doesn't matter, a draw picks one of size()
+ * tiles with equal chances by walking the counts
+ */
+class Bag {
+  public:
+    void add(const Letter tile, const int count = 1);
+    void remove(const Letter tile);
+
     /*
-     * @brief returns random number [0, bag_size-num_of_returns)
-     *
-     * @retval {int} -1 if num_of_returns >= bag_size
+     * @brief takes a random tile out of the bag
+     * @retval {kNoLetter} bag is empty
      */
-    int decrement_random_tile();
+    Letter draw(Randomizer &randomizer);
+
+    int count(const Letter tile) const { return counts_[tile]; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+  private:
+    std::array<std::uint16_t, kBlank + 1> counts_{};
+    std::size_t size_ = 0;
 };
 
 struct GameState {
   public:
     friend class ViewBuilder;
+    friend class ScrabbleGame;
 
-    // max num of tiles in player hand
+    // max num of tiles in player hand, Rules::kHandSize of the variant
     const unsigned long TILES_MAX_IN_HAND;
 
     // coordinates of new_tiles in same order
     std::vector<std::vector<int>> new_tiles_coordinates;
     // new_letters that player tries to place
-    std::vector<char32_t> new_letters;
+    std::vector<Letter> new_letters;
     /*
      * @brief score for new tiles
      *
@@ -107,20 +139,7 @@ struct GameState {
      */
     std::vector<int64_t> players;
 
-    std::vector<char32_t> bag;
-    /*
-     * @brief holds two-dimensional vector, which represents letters on board
-     *
-     * @notes board_letters[x][y]
-     */
-    std::vector<std::vector<std::optional<char32_t>>> board_letters;
-    /*
-     * @brief holds two-dimensional vector, which represents price of tiles on
-     * board
-     *
-     * @notes board_prices[x][y]
-     */
-    std::vector<std::vector<int>> board_prices;
+    Bag bag;
 
     /*
      * @brief fills player's hand with tiles
@@ -134,29 +153,40 @@ struct GameState {
     /*
      * @brief constructor of GameState
      *
-     * @param {tiles_max} max num of tiles in player hand
-     * @param {players_num} number of players
-     * @param {bag_size} number of tiles in bag
-     * @param {jokers_num} number of jokers in bag
+     * @param {variant} hand size, bag size and jokers are of its Rules
      * @param {default_tiles} array with all possible tiles with tiles necessary
      * frequency
+     * @param {seed} seed of all random draws of the game
      */
-    GameState(const int &tiles_max, const int &bag_size, const int &jokers_num,
-              const std::array<char32_t, 128> &default_tiles);
+    GameState(const Variant variant,
+              const std::array<Letter, 128> &default_tiles,
+              const std::uint64_t seed);
+
+    std::uint64_t seed() const { return randomizer.seed(); }
 
   private:
     Randomizer randomizer;
     /*
-     * @brief fills players bags with tiles, used in initializer
+     * @brief fills bag with tiles, used in initializer: all of default_tiles
+     * if there is room for exactly them, else tiles drawn from them at random
      */
     void FillBag_(const int &bag_size, const int &jokers_num,
-                  const std::array<char32_t, 128> &default_tiles);
+                  const std::array<Letter, 128> &default_tiles);
     /*
      * @brief Tries to draw a Tile from bag
-     * @retval {char32_t} returns letter from bag (random), if value of char ==
-     * 0, then bag is empty
+     * @retval {Letter} returns letter from bag (random), if value is
+     * kNoLetter, then bag is empty
      */
-    char32_t DrawTile_();
+    Letter DrawTile_();
+};
+
+/*
+ * @brief board of a variant with the cross checks of it, what a game is
+ * played on
+ */
+template <Variant V> struct Table {
+    BasicBoard<V> board;
+    BasicCrossChecks<V> cross_checks;
 };
 
 class ScrabbleGame {
@@ -164,24 +194,41 @@ class ScrabbleGame {
     /*
      * @brief Creates new game instance with default values
      *
-     * @param {tiles_max} max num of tiles in player hand, def=7, recomended >=
-     * 7
+     * @param {dictionary} words accepted in this game
      * @param {players_num} num of players, def=2, must be >= 2
-     * @param {bag_size} how much letters in bag
-     * @param {jokers_num} how much jokers in bag
+     * @param {variant} board, hand size, bag size and jokers of the game, see
+     * Rules
+     * @param {seed} seed of all random draws, the same seed and the same
+     * moves give the same game
      * @param {default_tiles} array with all possible tiles with tiles necessary
      * frequency
+     * @param {alphabet} alphabet default_tiles and all letters are encoded in
+     */
+    ScrabbleGame(DictionaryHandle dictionary, const int &players_num = 2,
+                 const Variant variant = Variant::standard,
+                 const std::uint64_t seed = Randomizer::RandomSeed(),
+                 const std::array<Letter, 128> &default_tiles = defaultTiles,
+                 const Alphabet &alphabet = kRussianAlphabet);
+
+    /*
+     * @brief game rebuilt from its log: a new game with the seed of log and
+     * players, every move of log played on it again
+     *
+     * @param {players} players of the logged game in the same order
+     * @note other parameters must be the same as of the logged game
+     * @retval {nullopt} a move of log is not legal in the rebuilt game
      */
-    ScrabbleGame(std::function<bool(const std::u32string &word)> word_checker,
-                 const int &tiles_max = 7, const int &players_num = 2,
-                 const int &bag_size = 131, const int &jokers_num = 3,
-                 const std::array<char32_t, 128> &default_tiles = defaultTiles);
+    static std::optional<ScrabbleGame>
+    Replay(DictionaryHandle dictionary, const std::vector<int64_t> &players,
+           const MoveLog &log, const Variant variant = Variant::standard,
+           const std::array<Letter, 128> &default_tiles = defaultTiles,
+           const Alphabet &alphabet = kRussianAlphabet);
 
     /*
      * @brief Tries to place a word on board (validates a pending placement)
      *
      * @param {coordinates} vector{{x,y}, ...} where Tiles placed
-     * @param {tiles} vector of letters of word
+     * @param {tiles} vector of letters of word, kBlankFlag marks blanks
      *
      * @note on success state_.score holds the score for the pending placement;
      *       on any failure state_.score is left at -1
@@ -190,7 +237,7 @@ class ScrabbleGame {
      *         (never throws, so callers can report it directly)
      */
     std::string TryPlaceTiles(std::vector<std::vector<int>> &&coordinates,
-                              std::vector<char32_t> &&tiles);
+                              std::vector<Letter> &&tiles);
 
     /*
      * @brief Places tiles on board if possible
@@ -201,11 +248,105 @@ class ScrabbleGame {
     int SubmitWord();
 
     /*
-     * @brief returns GameState
+     * @brief plays move for the current player in O(tiles of the move),
+     * straight from its letters and placed bits; with Undo it is the make
+     * and unmake of a search
+     *
+     * @notes move has to be one MoveGenerator found for the board and the
+     * hand of the current player: only that its cells are free and its
+     * tiles are in hand is checked, its words and score are taken as they
+     * are
+     * @retval {-1} move can't be made
+     * @retval {>=0} score of move
      */
-    GameState get_game_state();
+    int Apply(const Move &move);
 
-    std::vector<char32_t> get_player_hand(const int64_t id);
+    /*
+     * @brief reverts the last submitted word, change or pass in O(tiles of
+     * the move): board, cross checks, hands, bag, scores, turn, random
+     * draws and move log are as they were before it
+     *
+     * @notes only the last moves, as many as there are players, can be
+     * reverted
+     * @retval {false} no move to revert
+     */
+    bool Undo();
+
+    /*
+     * @brief number of Undo calls that revert the last move of player and
+     * every move after it
+     *
+     * @param {player} index in playersState
+     * @retval {-1} player has no move to revert
+     */
+    int undo_depth(const int player) const;
+
+    /*
+     * @brief read-only view of GameState, nothing is copied
+     *
+     * @notes valid as long as the game, changes of the game show through it
+     */
+    const GameState &get_game_state() const;
+
+    /*
+     * @brief read-only view of the hand of a player, valid till the next
+     * change of the game
+     *
+     * @retval {empty} player is not in game
+     */
+    std::span<const Letter> player_hand(const int64_t id) const;
+
+    /*
+     * @brief best moves for the hand of a player, see MoveGenerator
+     *
+     * @param {limit} max number of moves returned
+     * @param {deadline} search stops after it with the moves found so far
+     * @retval {empty} no legal move, player is not in game or the game has
+     * no dictionary to take words from
+     */
+    std::vector<Move>
+    Hint(const int64_t user_id, const std::size_t limit,
+         MoveGenerator::Deadline deadline = MoveGenerator::Deadline::max())
+        const;
+
+    /*
+     * @brief same as Hint above, the search is split between workers tasks
+     * of task_processor
+     */
+    std::vector<Move> Hint(const int64_t user_id, const std::size_t limit,
+                           MoveGenerator::Deadline deadline,
+                           userver::engine::TaskProcessor &task_processor,
+                           const std::size_t workers) const;
+
+    /*
+     * @brief plays out the rest of the game for the player, see
+     * EndgameSolver
+     *
+     * @retval {nullopt} bag is not empty, the game is not of two players,
+     * player is not in game or there is no dictionary
+     */
+    std::optional<EndgameResult>
+    SolveEndgame(const int64_t user_id, const EndgameOptions &options) const;
+
+    /*
+     * @brief alphabet letters of this game are encoded in
+     */
+    const Alphabet &alphabet() const;
+
+    Variant variant() const;
+
+    /*
+     * @brief calls visitor with the committed board, a BasicBoard of the
+     * variant of the game
+     */
+    template <typename Visitor>
+    decltype(auto) visit_board(Visitor &&visitor) const {
+        return std::visit(
+            [&visitor](const auto &table) -> decltype(auto) {
+                return visitor(table.board);
+            },
+            table_);
+    }
 
     /*
      * @brief sets players to inputted vector [0] - host user_id
@@ -240,6 +381,21 @@ class ScrabbleGame {
      */
     int get_pending_score() const;
 
+    /*
+     * @brief number of tiles left in bag
+     */
+    std::size_t bag_size() const;
+
+    /*
+     * @brief seed the game was created with
+     */
+    std::uint64_t seed() const;
+
+    /*
+     * @brief seed and every submitted word, change and pass of the game
+     */
+    const MoveLog &move_log() const;
+
     /*
      * @brief passes the current player's turn: clears pending tiles and
      * advances current_player
@@ -252,19 +408,20 @@ class ScrabbleGame {
      * @param {user_id} id of the player whose hand is modified
      * @param {tiles} tiles to return to the bag
      * @retval {true} OK
-     * @retval {false} player doesn't have one of the requested tiles
+     * @retval {false} player doesn't have one of the requested tiles, the
+     * hand is left as it was
      */
-    bool Change(const int64_t user_id, std::vector<char32_t> tiles);
+    bool Change(const int64_t user_id, std::vector<Letter> tiles);
 
     /*
      * @returns index of player whose turn is now
      */
-    int whose_move();
+    int whose_move() const;
 
     /*
      * @returns id of player whose turn is now
      */
-    int64_t whose_move_id();
+    int64_t whose_move_id() const;
 
 #ifdef DEBUG
     void draw();
@@ -273,73 +430,122 @@ class ScrabbleGame {
   private:
     const int players_max_;
 
+    const Alphabet &alphabet_;
     GameState state_;
-    std::function<bool(const std::u32string &word)> word_checker;
+    DictionaryHandle dictionary_;
+    // committed board and its checks, updated by SubmitWord around new
+    // tiles; the variant is chosen once, every method below runs the code
+    // compiled for its sizes
+    std::variant<Table<Variant::standard>, Table<Variant::super>,
+                 Table<Variant::quick>>
+        table_;
+    MoveLog log_;
 
     /*
-     * @brief Checks the pending placement inside TryPlaceTiles()
-     *
-     * @param {word_checker(std::u32string&)} function to check existence of
-     * words, should return true if word exists, else if not
+     * @brief what Undo needs to revert one move
+     */
+    struct UndoRecord {
+        LoggedMove::Kind kind;
+        int player;
+        // current_player before the move, not always player: a change may
+        // come out of turn
+        int turn;
+        int score = 0;
+        // hand before the move
+        std::array<Letter, kMaxLineLength> hand{};
+        int hand_size;
+        // number of tiles drawn after the move, the last ones of the hand
+        int drawn = 0;
+        // submit: BasicBoard::index of the tiles placed, change: tiles
+        // returned
+        std::array<int, kMaxLineLength> tiles{};
+        int tiles_size = 0;
+        Randomizer randomizer;
+        std::size_t log_size;
+    };
+    // moves that can be reverted, the last one at the back, at most one
+    // per player
+    std::vector<UndoRecord> history_;
+
+    /*
+     * @brief record of the move player is about to make
+     */
+    UndoRecord Remember_(const LoggedMove::Kind kind, const int player) const;
+
+    /*
+     * @brief adds record to history_, dropping the oldest one if it is full
+     */
+    void Keep_(const UndoRecord &record);
+
+    /*
+     * @brief clears pending tiles and hands the turn to the next player
+     */
+    void NextTurn_();
+
+    /*
+     * @brief forgets the tiles placed but not submitted and their score
+     */
+    void ClearPending_();
+
+    /*
+     * @brief Checks the pending placement inside TryPlaceTiles(): the main
+     * word is looked up in dictionary_, perpendicular words are bit tests of
+     * table.cross_checks
      *
      * @note on success state_.score is set to the placement score; on failure
      *       state_.score is set to -1
      * @retval {""} placement is valid
      * @retval {non-empty} reason the placement was rejected (never throws)
      */
-    std::string TilesCheck_();
+    template <Variant V> std::string TilesCheck_(const Table<V> &table);
 
-    // TODO: receives only horiz or vert placed tiles,
-    // TODO: can return words with one letter
     /*
-     * @brief gathers all words that were formed by placed tiles
-     *
-     * @retval {vector<u32string>} vector with all words
-     *
-     *
-     * @param {&new_board_letters} board with all new placed tiles
-     * @param {&coordinates} vector with coordinates of all new placed tiles
-     * @param {&horizontal} should be 1 if all tiles in horizontal row, 0 if all
-     * tiles in vertical row
+     * @retval {nullptr} player is not in game
      */
-    std::vector<std::u32string> GetNewWords_(
-        std::vector<std::vector<std::optional<char32_t>>> &new_board_letters,
-        std::vector<std::vector<int>> &coordinates, const bool &horizontal);
+    const std::vector<Letter> *hand_(const int64_t user_id) const;
 
     /*
      * @brief gathers word that were formed by one tile, which belongs to tiles
      * forming horizontal line
      *
-     * @retval {u32string} word formed by this tile
+     * @retval {PlacedWord} word formed by this tile
      *
-     * @param {&new_board_letters} board with all new placed tiles
+     * @param {&new_board_letters} committed board with new placed tiles over it
      * @param {&tile_coords} coords of tile to check formed words from
      */
-    std::u32string horizontal_check_(
-        std::vector<std::vector<std::optional<char32_t>>> &new_board_letters,
-        std::vector<int> &tile_coords);
+    template <Variant V>
+    PlacedWord horizontal_check_(const BasicBoardView<V> &new_board_letters,
+                                 std::vector<int> &tile_coords);
 
     /*
      * @brief gathers word that were formed by one tile, which belongs to tiles
      * forming vertical line
      *
-     * @retval {u32string} word formed by this tile
+     * @retval {PlacedWord} word formed by this tile
      *
-     * @param {&new_board_letters} board with all new placed tiles
+     * @param {&new_board_letters} committed board with new placed tiles over it
      * @param {&tile_coords} coords of tile to check formed words from
      */
-    std::u32string vertical_check_(
-        std::vector<std::vector<std::optional<char32_t>>> &new_board_letters,
-        std::vector<int> &tile_coords);
+    template <Variant V>
+    PlacedWord vertical_check_(const BasicBoardView<V> &new_board_letters,
+                               std::vector<int> &tile_coords);
 
     /*
      * @brief calculates value of word
      *
-     * @param {&word} letter sequence to score, joker = '*'
+     * @param {&board} committed board
+     * @param {&new_board_letters} committed board with new placed tiles over it
+     * @param {&word} word to score, blanks are worth nothing
+     *
+     * @notes premiums of kPremiumLayout count only for cells that are still
+     * empty on the committed board, i.e. for tiles of the scored move
      *
      * @retval {int} value of word
      */
-    int calculate_score_(const std::u32string &word) const;
+    template <Variant V>
+    int calculate_score_(const BasicBoard<V> &board,
+                         const BasicBoardView<V> &new_board_letters,
+                         const PlacedWord &word) const;
 };
 
 } // namespace ScrabbleGame
@@ -1,6 +1,8 @@
 #include "api/Cors.hpp"
 #include "api/http_handlers.hpp"
 #include "api/websocket.hpp"
+#include "dictionary/DictionaryComponent.hpp"
+#include "session/BotPlayer.hpp"
 #include "session/GameStorage.hpp"
 #include <userver/clients/dns/component.hpp>
 #include <userver/testsuite/testsuite_support.hpp>
@@ -20,6 +22,8 @@ int main(int argc, char *argv[]) {
             .Append<services::http::RegistrationHandler>()
             .Append<services::cors::CorsHandler>()
             .Append<ScrabbleGame::StorageComponent>()
+            .Append<ScrabbleGame::DictionaryComponent>()
+            .Append<ScrabbleGame::BotComponent>()
             .Append<components::SQLite>("sqlitedb")
             .Append<components::TestsuiteSupport>()
             .Append<clients::dns::Component>();
@@ -0,0 +1,308 @@
+#include "BinaryProtocol.hpp"
+
+#include "game/Board.hpp"
+
+namespace ScrabbleGame {
+
+namespace {
+
+void PutByte(std::string &out, const std::uint8_t byte) {
+    out.push_back(static_cast<char>(byte));
+}
+
+void PutVarint(std::string &out, std::uint64_t value) {
+    while (value >= 0x80) {
+        PutByte(out, static_cast<std::uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    PutByte(out, static_cast<std::uint8_t>(value));
+}
+
+void PutSigned(std::string &out, const std::int64_t value) {
+    PutVarint(out, (static_cast<std::uint64_t>(value) << 1) ^
+                       static_cast<std::uint64_t>(value >> 63));
+}
+
+/*
+ * @brief reads a command, every read past the end fails it
+ */
+class Reader {
+  public:
+    explicit Reader(std::span<const std::uint8_t> bytes) : bytes_(bytes) {}
+
+    bool ok() const { return ok_; }
+    bool done() const { return pos_ == bytes_.size(); }
+
+    std::uint8_t Byte() {
+        if (done()) {
+            ok_ = false;
+            return 0;
+        }
+        return bytes_[pos_++];
+    }
+
+    std::uint64_t Varint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const std::uint8_t byte = Byte();
+            value |= std::uint64_t{byte & 0x7fu} << shift;
+            if (!(byte & 0x80))
+                return value;
+        }
+        ok_ = false;
+        return 0;
+    }
+
+  private:
+    std::span<const std::uint8_t> bytes_;
+    std::size_t pos_ = 0;
+    bool ok_ = true;
+};
+
+} // namespace
+
+std::optional<Protocol> ProtocolFromName(const std::string_view name) {
+    if (name == "json")
+        return Protocol::json;
+    if (name == "binary")
+        return Protocol::binary;
+    return std::nullopt;
+}
+
+std::optional<PlayerCommand>
+BinaryProtocol::DecodeCommand(std::span<const std::uint8_t> bytes) {
+    Reader reader(bytes);
+    PlayerCommand command;
+    command.action = static_cast<PlayerAction>(reader.Byte());
+    switch (command.action) {
+    case PlayerAction::place: {
+        const int n = reader.Byte();
+        command.coordinates.reserve(n);
+        command.tiles.reserve(n);
+        for (int i = 0; i < n && reader.ok(); ++i) {
+            const int x = reader.Byte();
+            const int y = reader.Byte();
+            command.coordinates.push_back({x, y});
+            command.tiles.push_back(reader.Byte());
+        }
+        break;
+    }
+    case PlayerAction::change: {
+        const int n = reader.Byte();
+        command.tiles.reserve(n);
+        for (int i = 0; i < n && reader.ok(); ++i)
+            command.tiles.push_back(reader.Byte());
+        break;
+    }
+    case PlayerAction::state:
+        if (!reader.done())
+            command.version = reader.Varint();
+        break;
+    case PlayerAction::hint:
+        if (!reader.done())
+            command.limit = reader.Byte();
+        break;
+    case PlayerAction::takeback:
+        if (!reader.done())
+            command.approve = reader.Byte() != 0;
+        break;
+    case PlayerAction::pass:
+    case PlayerAction::submit:
+    case PlayerAction::end:
+        break;
+    default:
+        return std::nullopt;
+    }
+    if (!reader.ok() || !reader.done())
+        return std::nullopt;
+    return command;
+}
+
+std::string BinaryProtocol::EncodeCommand(const PlayerCommand &command) {
+    std::string out;
+    PutByte(out, static_cast<std::uint8_t>(command.action));
+    switch (command.action) {
+    case PlayerAction::place:
+        PutByte(out, static_cast<std::uint8_t>(command.tiles.size()));
+        for (std::size_t i = 0; i < command.tiles.size(); ++i) {
+            PutByte(out, static_cast<std::uint8_t>(command.coordinates[i][0]));
+            PutByte(out, static_cast<std::uint8_t>(command.coordinates[i][1]));
+            PutByte(out, command.tiles[i]);
+        }
+        break;
+    case PlayerAction::change:
+        PutByte(out, static_cast<std::uint8_t>(command.tiles.size()));
+        for (const Letter tile : command.tiles)
+            PutByte(out, tile);
+        break;
+    case PlayerAction::state:
+        PutVarint(out, command.version);
+        break;
+    case PlayerAction::hint:
+        if (command.limit)
+            PutByte(out, static_cast<std::uint8_t>(*command.limit));
+        break;
+    case PlayerAction::takeback:
+        if (command.approve)
+            PutByte(out, *command.approve);
+        break;
+    default:
+        break;
+    }
+    return out;
+}
+
+std::string BinaryProtocol::Setup(const GameView &view,
+                                  const Alphabet &alphabet) {
+    std::string out;
+    out.reserve(16 + view.cells.size() + 4 * alphabet.size() +
+                4 * view.players.size());
+    PutByte(out, static_cast<std::uint8_t>(Frame::setup));
+    VisitVariant(view.variant, [&](auto variant) {
+        using Board = BasicBoard<decltype(variant)::value>;
+        PutByte(out, static_cast<std::uint8_t>(view.variant));
+        PutByte(out, static_cast<std::uint8_t>(Board::kWidth));
+        PutByte(out, static_cast<std::uint8_t>(Board::kHeight));
+        for (int x = 0; x < Board::kWidth; ++x) {
+            for (int y = 0; y < Board::kHeight; ++y)
+                PutByte(out, static_cast<std::uint8_t>(Board::price(x, y)));
+        }
+    });
+    PutByte(out, static_cast<std::uint8_t>(alphabet.size()));
+    for (int i = 1; i <= alphabet.size(); ++i) {
+        const Letter letter = static_cast<Letter>(i);
+        PutVarint(out, alphabet.decode(letter));
+        PutVarint(out, static_cast<std::uint64_t>(alphabet.value(letter)));
+    }
+    PutByte(out, static_cast<std::uint8_t>(view.players.size()));
+    for (const int64_t id : view.players)
+        PutSigned(out, id);
+    return out;
+}
+
+std::string BinaryProtocol::PublicState(const GameView &view) {
+    std::string out;
+    out.reserve(16 + 4 * view.scores.size() + view.cells.size());
+    PutByte(out, static_cast<std::uint8_t>(view.current_player));
+    PutVarint(out, view.bag_size);
+    PutByte(out, static_cast<std::uint8_t>(view.scores.size()));
+    for (const int score : view.scores)
+        PutSigned(out, score);
+    out.append(view.cells.begin(), view.cells.end());
+    return out;
+}
+
+std::string BinaryProtocol::PrivateState(const GameView &view,
+                                         const int64_t player_id) {
+    std::string out;
+    const auto hand = view.hands.find(player_id);
+    const bool pending = view.whose_move == player_id;
+    PutByte(out, (hand != view.hands.end() ? 1 : 0) | (pending ? 2 : 0));
+    if (hand != view.hands.end()) {
+        PutByte(out, static_cast<std::uint8_t>(hand->second.size()));
+        out.append(hand->second.begin(), hand->second.end());
+    }
+    if (pending)
+        PutSigned(out, view.pending_score);
+    return out;
+}
+
+std::string BinaryProtocol::PublicDelta(const GameView &from,
+                                        const GameView &to) {
+    std::string out;
+    const bool turn = from.current_player != to.current_player;
+    const bool bag = from.bag_size != to.bag_size;
+    PutByte(out, (turn ? 1 : 0) | (bag ? 2 : 0));
+    if (turn)
+        PutByte(out, static_cast<std::uint8_t>(to.current_player));
+    if (bag)
+        PutVarint(out, to.bag_size);
+
+    // a move changes a few cells, a takeback empties them again
+    std::string cells;
+    std::size_t changed = 0;
+    for (std::size_t i = 0; i < to.cells.size(); ++i) {
+        if (i < from.cells.size() && from.cells[i] == to.cells[i])
+            continue;
+        PutByte(cells, static_cast<std::uint8_t>(i / to.height));
+        PutByte(cells, static_cast<std::uint8_t>(i % to.height));
+        PutByte(cells, to.cells[i]);
+        ++changed;
+    }
+    PutVarint(out, changed);
+    out += cells;
+
+    std::string scores;
+    changed = 0;
+    for (std::size_t i = 0; i < to.scores.size(); ++i) {
+        if (i < from.scores.size() && from.scores[i] == to.scores[i])
+            continue;
+        PutByte(scores, static_cast<std::uint8_t>(i));
+        PutSigned(scores, to.scores[i]);
+        ++changed;
+    }
+    PutByte(out, static_cast<std::uint8_t>(changed));
+    out += scores;
+    return out;
+}
+
+std::string BinaryProtocol::PrivateDelta(const GameView &from,
+                                         const GameView &to,
+                                         const int64_t player_id) {
+    std::string out;
+    const auto to_hand = to.hands.find(player_id);
+    const auto from_hand = from.hands.find(player_id);
+    const bool hand = to_hand != to.hands.end() &&
+                      (from_hand == from.hands.end() ||
+                       from_hand->second != to_hand->second);
+    const bool pending = to.whose_move == player_id;
+    if (!hand && !pending)
+        return out;
+    PutByte(out, (hand ? 1 : 0) | (pending ? 2 : 0));
+    if (hand) {
+        PutByte(out, static_cast<std::uint8_t>(to_hand->second.size()));
+        out.append(to_hand->second.begin(), to_hand->second.end());
+    }
+    if (pending)
+        PutSigned(out, to.pending_score);
+    return out;
+}
+
+std::string BinaryProtocol::StateMessage(const std::uint64_t version,
+                                         const std::string_view public_state,
+                                         const std::string_view private_state) {
+    std::string message;
+    if (public_state.empty()) {
+        PutByte(message, static_cast<std::uint8_t>(Frame::lobby));
+        PutVarint(message, version);
+        return message;
+    }
+    message.reserve(16 + public_state.size() + private_state.size());
+    PutByte(message, static_cast<std::uint8_t>(Frame::state));
+    PutVarint(message, version);
+    message += public_state;
+    if (private_state.empty())
+        PutByte(message, 0);
+    else
+        message += private_state;
+    return message;
+}
+
+std::string BinaryProtocol::DeltaMessage(const std::uint64_t base,
+                                         const std::uint64_t version,
+                                         const std::string_view public_delta,
+                                         const std::string_view private_delta) {
+    std::string message;
+    message.reserve(24 + public_delta.size() + private_delta.size());
+    PutByte(message, static_cast<std::uint8_t>(Frame::delta));
+    PutVarint(message, base);
+    PutVarint(message, version);
+    message += public_delta;
+    if (private_delta.empty())
+        PutByte(message, 0);
+    else
+        message += private_delta;
+    return message;
+}
+
+} // namespace ScrabbleGame
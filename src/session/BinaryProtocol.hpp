@@ -0,0 +1,139 @@
+#pragma once
+
+#include "game/GameViewBuilder.hpp"
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ScrabbleGame {
+
+/*
+ * @brief format of the frames of one websocket connection, chosen by
+ * "protocol" of the first message
+ */
+enum class Protocol : std::uint8_t { json, binary };
+
+std::optional<Protocol> ProtocolFromName(const std::string_view name);
+
+enum class PlayerAction : std::uint8_t {
+    // try to place tiles on board
+    place = 1,
+    // change tiles in hand
+    change = 2,
+    // pass the move
+    pass = 3,
+    // try to submit tiles placed on board
+    submit = 4,
+    // end a game
+    end = 5,
+    // try to receive cur game_state
+    state = 6,
+    // receive best moves for own hand
+    hint = 7,
+    // take back own last move, players other than host ask the host
+    takeback = 8
+};
+
+/*
+ * @brief message of a player, the same whatever protocol it came in
+ */
+struct PlayerCommand {
+    PlayerAction action = PlayerAction::state;
+    // place: vector{{x,y}, ...} of the tiles
+    std::vector<std::vector<int>> coordinates;
+    // place: tiles placed, change: tiles returned to the bag
+    std::vector<Letter> tiles;
+    // state: version the client has, 0 if none
+    std::uint64_t version = 0;
+    // hint: max number of moves
+    std::optional<int> limit;
+    // takeback: answer of the host to a request
+    std::optional<bool> approve;
+};
+
+/*
+ * @brief binary frames of Protocol::binary
+ *
+ * @notes everything is bytes, numbers wider than a byte are LEB128 varints,
+ * signed ones zigzag encoded; letters are engine codes, see Letter
+ *
+ * commands, client to server: action, then
+ * - place: n, n times x, y, letter
+ * - change: n, n letters
+ * - state: version
+ * - hint: limit, optional
+ * - takeback: approve (0 or 1) if the host answers a request
+ * - nothing for the others
+ *
+ * frames, server to client: kind, then
+ * - lobby: version
+ * - setup: variant, width, height, width * height prices (int8, see
+ *   BasicBoard::price) in the flat order of the board, n letters, n times
+ *   UTF-32 code and value of the letters from code 1, n players, n ids; sent
+ *   once before the first full state of a connection and of a resync
+ * - state: version, public state, private part
+ * - delta: base, version, public delta, private part
+ * public state: current_player, bag_size, n scores by index in the players
+ * of the setup, width * height cells in the flat order of the board
+ * public delta: flags (1 current_player, 2 bag_size), current_player if
+ * flagged, bag_size if flagged, n cells, n times x, y, letter (kNoLetter for
+ * a cell emptied by a takeback), n scores, n times index and score
+ * private part: flags (1 hand, 2 pending_score), n and n letters of the hand
+ * if flagged, pending_score if flagged; the same rules as the json ones, see
+ * ViewBuilder
+ *
+ * errors, hints and takeback requests stay json text frames
+ *
+ * a connection that asked for "compression": "deflate" may also get
+ * deflated frames of either protocol: a binary frame of Frame::deflated,
+ * then raw deflate data, see FrameDeflater of the websocket handler
+ */
+class BinaryProtocol {
+  public:
+    enum class Frame : std::uint8_t {
+        lobby = 1,
+        state = 2,
+        delta = 3,
+        // frame of any protocol deflated by the websocket handler
+        deflated = 4,
+        setup = 5
+    };
+
+    /*
+     * @brief setup frame of a game, see ViewBuilder::setup
+     */
+    static std::string Setup(const GameView &view, const Alphabet &alphabet);
+
+    /*
+     * @retval {nullopt} bytes are not a command
+     */
+    static std::optional<PlayerCommand>
+    DecodeCommand(std::span<const std::uint8_t> bytes);
+    static std::string EncodeCommand(const PlayerCommand &command);
+
+    static std::string PublicState(const GameView &view);
+    static std::string PrivateState(const GameView &view,
+                                    const int64_t player_id);
+    static std::string PublicDelta(const GameView &from, const GameView &to);
+    static std::string PrivateDelta(const GameView &from, const GameView &to,
+                                    const int64_t player_id);
+
+    /*
+     * @param {public_state} result of PublicState(), empty if the game is
+     * not ongoing
+     * @param {private_state} result of PrivateState(), empty if the
+     * recipient has no seat
+     */
+    static std::string StateMessage(const std::uint64_t version,
+                                    const std::string_view public_state,
+                                    const std::string_view private_state);
+    static std::string DeltaMessage(const std::uint64_t base,
+                                    const std::uint64_t version,
+                                    const std::string_view public_delta,
+                                    const std::string_view private_delta);
+};
+
+} // namespace ScrabbleGame
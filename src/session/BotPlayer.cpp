@@ -0,0 +1,67 @@
+#include "BotPlayer.hpp"
+
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace ScrabbleGame {
+
+BotClient::BotClient(engine::TaskProcessor &task_processor,
+                     const BotSettings settings)
+    : settings_(settings), tasks_(task_processor) {}
+
+void BotClient::Schedule(std::shared_ptr<GameRoom> room) {
+    tasks_.AsyncDetach("bot-move", [room = std::move(room),
+                                    settings = settings_] {
+        room->play_bots(settings);
+    });
+}
+
+BotComponent::BotComponent(const components::ComponentConfig &config,
+                           const components::ComponentContext &context)
+    : components::ComponentBase(config, context),
+      client_(std::make_shared<BotClient>(
+          context.GetTaskProcessor(config["task-processor"].As<std::string>()),
+          BotSettings{
+              std::chrono::milliseconds(
+                  config["move-time-budget-ms"].As<int>(200)),
+              std::chrono::milliseconds(
+                  config["hint-time-budget-ms"].As<int>(20)),
+              config["move-workers"].As<std::size_t>(1),
+              config["endgame-table-size-mb"].As<std::size_t>(16) << 20})) {}
+
+std::shared_ptr<BotClient> BotComponent::GetBots() { return client_; }
+
+yaml_config::Schema BotComponent::GetStaticConfigSchema() {
+    return yaml_config::MergeSchemas<components::ComponentBase>(R"(
+type: object
+description: bot seats of games
+additionalProperties: false
+properties:
+    task-processor:
+        type: string
+        description: task processor bot moves are searched on
+    move-time-budget-ms:
+        type: integer
+        description: time one bot may search for its move
+        defaultDescription: 200
+        minimum: 1
+    hint-time-budget-ms:
+        type: integer
+        description: time the hints of a player are searched for
+        defaultDescription: 20
+        minimum: 1
+    move-workers:
+        type: integer
+        description: tasks of task-processor one bot move is searched by
+        defaultDescription: 1
+        minimum: 1
+    endgame-table-size-mb:
+        type: integer
+        description: memory of the endgame search of one bot move
+        defaultDescription: 16
+        minimum: 1
+)");
+}
+
+} // namespace ScrabbleGame
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+
+#include <userver/components/component_base.hpp>
+#include <userver/concurrent/background_task_storage.hpp>
+#include <userver/engine/task/task_processor_fwd.hpp>
+#include <userver/yaml_config/schema.hpp>
+
+#include "GameRoom.hpp"
+
+namespace ScrabbleGame {
+
+/*
+ * @brief how bots search their moves, and players their hints
+ */
+struct BotSettings {
+    // time one bot may search for its move
+    std::chrono::milliseconds move_budget;
+    // time the hints of a player are searched for, inline in the room
+    std::chrono::milliseconds hint_budget;
+    // tasks one bot move is searched by
+    std::size_t workers;
+    // memory of the transposition table of one endgame search
+    std::size_t endgame_table_bytes;
+};
+
+/*
+ * @brief plays the turns of bot seats, see GameRoom::attach_bot
+ *
+ * @notes bot moves are searched on a task processor of their own, so a long
+ * search never delays rooms served by main-task-processor
+ */
+class BotClient final {
+  public:
+    BotClient(engine::TaskProcessor &task_processor, BotSettings settings);
+
+    /*
+     * @brief plays bot turns of room in background until a human has to move
+     */
+    void Schedule(std::shared_ptr<GameRoom> room);
+
+    const BotSettings &settings() const { return settings_; }
+
+  private:
+    const BotSettings settings_;
+    // destroyed first: cancels and waits for the bot turns in flight
+    concurrent::BackgroundTaskStorage tasks_;
+};
+
+class BotComponent final : public components::ComponentBase {
+  public:
+    // name of your component to refer in static config
+    static constexpr std::string_view kName = "bot-player";
+
+    BotComponent(const components::ComponentConfig &config,
+                 const components::ComponentContext &context);
+
+    std::shared_ptr<BotClient> GetBots();
+
+    static yaml_config::Schema GetStaticConfigSchema();
+
+  private:
+    std::shared_ptr<BotClient> client_;
+};
+
+} // namespace ScrabbleGame
@@ -1,11 +1,61 @@
 #include "GameRoom.hpp"
+#include "BotPlayer.hpp"
 #include "utils/utils.hpp"
+#include <algorithm>
+#include <utility>
 #include <userver/formats/parse/common_containers.hpp>
+#include <userver/engine/task/current_task.hpp>
+#include <userver/formats/serialize/common_containers.hpp>
 #include <userver/logging/log.hpp>
 
 namespace ScrabbleGame {
 
-GameRoom::PlayerAction GameRoom::from_string(const std::string &str) {
+namespace {
+
+/*
+ * @brief whether a client with known_version gets a delta of snapshot,
+ * otherwise it gets the full state
+ */
+bool IsDelta(const GameSnapshot &snapshot, const std::uint64_t known_version) {
+    if (snapshot.ongoing && known_version == snapshot.version)
+        return true;
+    return snapshot.has_delta && known_version + 1 == snapshot.version;
+}
+
+/*
+ * @brief message of the last snapshot for user_id in one protocol
+ *
+ * @param {unchanged} public delta of a snapshot to itself
+ */
+template <typename StateMessage, typename DeltaMessage>
+std::string StateForUser(const GameSnapshot &snapshot,
+                         const SerializedState &state,
+                         const u_int64_t user_id,
+                         const std::uint64_t known_version,
+                         const std::string_view unchanged,
+                         StateMessage state_message,
+                         DeltaMessage delta_message) {
+    const auto private_part = [&](const auto &parts) -> std::string_view {
+        const auto it = parts.find(user_id);
+        return it != parts.end() ? std::string_view{it->second}
+                                 : std::string_view{};
+    };
+    if (!IsDelta(snapshot, known_version)) {
+        return state_message(snapshot.version, state.public_state,
+                             private_part(state.private_states));
+    }
+    if (known_version == snapshot.version) {
+        // nothing public changed, the private state is a valid delta
+        return delta_message(known_version, snapshot.version, unchanged,
+                             private_part(state.private_states));
+    }
+    return delta_message(known_version, snapshot.version, state.public_delta,
+                         private_part(state.private_deltas));
+}
+
+} // namespace
+
+PlayerAction GameRoom::from_string(const std::string &str) {
     if (str == "place") {
         return PlayerAction::place;
     } else if (str == "change") {
@@ -18,12 +68,18 @@ GameRoom::PlayerAction GameRoom::from_string(const std::string &str) {
         return PlayerAction::end;
     } else if (str == "state") {
         return PlayerAction::state;
+    } else if (str == "hint") {
+        return PlayerAction::hint;
+    } else if (str == "takeback") {
+        return PlayerAction::takeback;
     }
     return PlayerAction::state;
 }
 
-GameRoom::GameRoom(const u_int64_t game_id, ScrabbleGame &&game)
-    : game_id_{game_id}, game_(game), ongoing_{false}, open_{true} {}
+GameRoom::GameRoom(const u_int64_t game_id, ScrabbleGame &&game,
+                   const std::chrono::milliseconds hint_budget)
+    : game_id_{game_id}, game_(game), ongoing_{false}, open_{true},
+      hint_budget_{hint_budget} {}
 
 void GameRoom::attach_session(const u_int64_t id,
                               std::shared_ptr<PlayerSession> session) {
@@ -33,173 +89,337 @@ void GameRoom::attach_session(const u_int64_t id,
     return;
 }
 
-const std::string GameRoom::wait_for_message(const u_int64_t user_id) {
+void GameRoom::attach_bot(const int64_t bot_id,
+                          std::shared_ptr<BotClient> bots) {
+    std::unique_lock<userver::engine::SharedMutex> lock(mutex_);
+    players_.push_back(bot_id);
+    bots_ = std::move(bots);
+}
+
+void GameRoom::play_bots(const BotSettings &settings) {
+    while (ongoing_) {
+        std::unique_lock<userver::engine::Mutex> lock(game_mutex_);
+        const int64_t player_id = game_.whose_move_id();
+        if (!is_bot(player_id))
+            return;
+        play_bot_move_(player_id, settings);
+        publish_snapshot_();
+        send_new_states();
+    }
+}
+
+void GameRoom::play_bot_move_(const int64_t bot_id,
+                              const BotSettings &settings) {
+    const auto deadline =
+        std::chrono::steady_clock::now() + settings.move_budget;
+    std::vector<Move> moves;
+    EndgameOptions options;
+    options.table_bytes = settings.endgame_table_bytes;
+    options.deadline = deadline;
+    if (const auto endgame = game_.bag_size() == 0
+                                 ? game_.SolveEndgame(bot_id, options)
+                                 : std::nullopt) {
+        LOG_DEBUG() << "bot " << bot_id << " searched endgame "
+                    << endgame->depth << " moves ahead, "
+                    << endgame->nodes_per_second << " nodes/s";
+        if (endgame->move)
+            moves.push_back(*endgame->move);
+    } else {
+        moves = game_.Hint(bot_id, 1, deadline,
+                           userver::engine::current_task::GetTaskProcessor(),
+                           settings.workers);
+    }
+    if (!moves.empty() &&
+        game_.TryPlaceTiles(moves.front().coordinates(), moves.front().tiles())
+            .empty()) {
+        LOG_DEBUG() << "bot " << bot_id << " scored " << moves.front().score;
+        game_.SubmitWord();
+        return;
+    }
+
+    const std::span<const Letter> hand = game_.player_hand(bot_id);
+    if (!hand.empty() && game_.bag_size() >= hand.size()) {
+        LOG_DEBUG() << "bot " << bot_id << " changes its hand";
+        game_.Change(bot_id, {hand.begin(), hand.end()});
+        return;
+    }
+    LOG_DEBUG() << "bot " << bot_id << " passes";
+    game_.Pass();
+}
+
+void GameRoom::schedule_bots_() {
+    if (bots_ && ongoing_ && is_bot(game_.whose_move_id()))
+        bots_->Schedule(shared_from_this());
+}
+
+OutgoingMessage GameRoom::wait_for_message(const u_int64_t user_id) {
     std::shared_lock<userver::engine::SharedMutex> lock(mutex_);
     return sessions_[user_id]->pop_wait();
 }
 
 void GameRoom::send_new_states() {
+    // a session gets the delta from the version it was sent last, or the
+    // full state if the snapshot has no delta from it; a client asks for
+    // its first state itself once connected
+    const auto snapshot = snapshot_.Read();
     std::shared_lock<userver::engine::SharedMutex> lock(mutex_);
     for (const auto &[user_id, session] : sessions_) {
-        session->send_raw_message(json_game_state_for_user(user_id));
+        const std::uint64_t known_version = session->version();
+        if (known_version != 0 && known_version != snapshot->version)
+            send_state_(*session, user_id, known_version);
+    }
+}
+
+void GameRoom::send_state_(PlayerSession &session, const u_int64_t user_id,
+                           const std::uint64_t known_version) const {
+    const auto snapshot = snapshot_.Read();
+    const Protocol protocol = session.protocol();
+    const auto send = [&](std::string msg) {
+        if (protocol == Protocol::binary)
+            session.send_binary_message(std::move(msg));
+        else
+            session.send_raw_message(msg);
+    };
+    // the layout of the game goes only before a full state, on connect and
+    // resync
+    if (snapshot->ongoing && !IsDelta(*snapshot, known_version)) {
+        const SerializedState &state =
+            protocol == Protocol::binary ? snapshot->binary : snapshot->json;
+        send(*state.setup);
     }
+    send(state_message_(*snapshot, protocol, user_id, known_version));
+    session.set_version(snapshot->version);
+}
+
+void GameRoom::set_protocol(const u_int64_t user_id,
+                            const Protocol protocol) {
+    {
+        std::shared_lock<userver::engine::SharedMutex> lock(mutex_);
+        if (const auto it = sessions_.find(user_id); it != sessions_.end())
+            it->second->set_protocol(protocol);
+    }
+    if (protocol != Protocol::binary || binary_.exchange(true))
+        return;
+    // the first binary session: a snapshot with the binary parts, pushed
+    // as usual so no one misses a version
+    std::unique_lock<userver::engine::Mutex> lock(game_mutex_);
+    if (!ongoing_)
+        return;
+    publish_snapshot_();
+    send_new_states();
+}
+
+void GameRoom::publish_snapshot_() {
+    GameSnapshot snapshot;
+    snapshot.version = ++version_;
+    snapshot.ongoing = ongoing_;
+    if (snapshot.ongoing) {
+        // the public part is the same for everyone, it is serialized once
+        // per version and only joined to the private parts when sent
+        const ViewBuilder views(game_);
+        const auto previous = snapshot_.Read();
+        const GameView &from = previous->view;
+        const GameView &to = snapshot.view = views.view();
+        snapshot.has_delta = previous->ongoing;
+        // the setup never changes during a game, so it is serialized once
+        if (previous->ongoing)
+            snapshot.json.setup = previous->json.setup;
+        if (!snapshot.json.setup)
+            snapshot.json.setup =
+                std::make_shared<const std::string>(views.setup());
+        snapshot.json.public_state = views.public_state();
+        if (snapshot.has_delta)
+            snapshot.json.public_delta = views.public_delta(from, to);
+
+        // the binary parts only once a session uses Protocol::binary
+        const bool binary = binary_;
+        if (binary) {
+            if (previous->ongoing)
+                snapshot.binary.setup = previous->binary.setup;
+            if (!snapshot.binary.setup)
+                snapshot.binary.setup = std::make_shared<const std::string>(
+                    BinaryProtocol::Setup(to, game_.alphabet()));
+            snapshot.binary.public_state = BinaryProtocol::PublicState(to);
+            if (snapshot.has_delta)
+                snapshot.binary.public_delta =
+                    BinaryProtocol::PublicDelta(from, to);
+        }
+
+        for (const int64_t id : game_.get_game_state().players) {
+            if (is_bot(id))
+                continue;
+            snapshot.json.private_states[id] = views.private_state(id);
+            if (snapshot.has_delta) {
+                snapshot.json.private_deltas[id] =
+                    views.private_delta(from, to, id);
+            }
+            if (!binary)
+                continue;
+            snapshot.binary.private_states[id] =
+                BinaryProtocol::PrivateState(to, id);
+            if (snapshot.has_delta) {
+                snapshot.binary.private_deltas[id] =
+                    BinaryProtocol::PrivateDelta(from, to, id);
+            }
+        }
+    }
+    snapshot_.Assign(std::move(snapshot));
 }
 
 void GameRoom::receive_message(const int user_id, const std::string &msg) {
-    formats::json::Value json_msg{formats::json::FromString(msg)};
+    const formats::json::Value json_msg{formats::json::FromString(msg)};
+    execute_(command_from_json_(json_msg), user_id);
+}
 
-    const std::string action_str = json_msg["action"].As<std::string>();
-    const PlayerAction action = from_string(action_str);
+void GameRoom::receive_binary_message(const int user_id,
+                                      const std::string &msg) {
+    const std::optional<PlayerCommand> command =
+        BinaryProtocol::DecodeCommand(std::span<const std::uint8_t>(
+            reinterpret_cast<const std::uint8_t *>(msg.data()), msg.size()));
+    if (!command) {
+        sessions_[user_id]->send_raw_message(R"({"error":"Bad message"})");
+        return;
+    }
+    execute_(*command, user_id);
+}
 
-    if (!ongoing_ && action != PlayerAction::end &&
-        action != PlayerAction::state) {
+PlayerCommand
+GameRoom::command_from_json_(const formats::json::Value &json_msg) {
+    PlayerCommand command;
+    command.action = from_string(json_msg["action"].As<std::string>());
+    switch (command.action) {
+    case PlayerAction::place: {
+        command.coordinates =
+            json_msg["coordinates"].As<std::vector<std::vector<int>>>();
+        std::string letters = json_msg["letters"].As<std::string>();
+        command.tiles = utf8str_to_letters_(game_.alphabet(), letters);
+        break;
+    }
+    case PlayerAction::change: {
+        std::string tiles = json_msg["tiles"].As<std::string>();
+        command.tiles = utf8str_to_letters_(game_.alphabet(), tiles);
+        break;
+    }
+    case PlayerAction::state:
+        command.version = json_msg["version"].As<std::uint64_t>(0);
+        break;
+    case PlayerAction::hint:
+        if (json_msg.HasMember("limit"))
+            command.limit = json_msg["limit"].As<int>();
+        break;
+    case PlayerAction::takeback:
+        if (json_msg.HasMember("approve"))
+            command.approve = json_msg["approve"].As<bool>();
+        break;
+    default:
+        break;
+    }
+    return command;
+}
+
+void GameRoom::execute_(const PlayerCommand &command, const int user_id) {
+    const PlayerAction action = command.action;
+
+    if (action == PlayerAction::state) {
+        // read from the snapshot, without waiting for moves in progress
+        LOG_DEBUG() << "action_state_ is called";
+        game_state_for_user_(command, user_id);
+        return;
+    }
+
+    if (!ongoing_ && action != PlayerAction::end) {
         LOG_DEBUG() << "Message declined, Game has not started";
         sessions_[user_id]->send_raw_message(
             R"({"error":"Game has not started"})");
         return;
     }
 
+    std::unique_lock<userver::engine::Mutex> lock(game_mutex_);
     switch (action) {
     case PlayerAction::change: {
         LOG_DEBUG() << "action_change_ is called";
-        action_change_(json_msg, user_id);
+        action_change_(command, user_id);
         break;
     }
     case PlayerAction::end: {
         LOG_DEBUG() << "action_end_ is called";
-        action_end_(json_msg, user_id);
+        action_end_(command, user_id);
         break;
     }
     case PlayerAction::pass: {
         LOG_DEBUG() << "action_pass_ is called";
-        action_pass_(json_msg, user_id);
+        action_pass_(command, user_id);
         break;
     }
     case PlayerAction::submit: {
         LOG_DEBUG() << "action_submit_ is called";
-        action_submit_(json_msg, user_id);
+        action_submit_(command, user_id);
         break;
     }
     case PlayerAction::place: {
         LOG_DEBUG() << "action_place_ is called";
-        action_place_(json_msg, user_id);
+        action_place_(command, user_id);
         break;
     }
-    case PlayerAction::state: {
-        LOG_DEBUG() << "action_state_ is called";
-        game_state_for_user_(json_msg, user_id);
+    case PlayerAction::state:
+        break;
+    case PlayerAction::hint: {
+        LOG_DEBUG() << "action_hint_ is called";
+        action_hint_(command, user_id);
+        break;
+    }
+    case PlayerAction::takeback: {
+        LOG_DEBUG() << "action_takeback_ is called";
+        action_takeback_(command, user_id);
         break;
     }
         // TODO: more_cases
     }
+    schedule_bots_();
 }
 
-std::string GameRoom::json_game_state_for_user(const u_int64_t user_id) {
-    formats::json::ValueBuilder json_vb;
-    if (!ongoing_) {
-        json_vb["ongoing"] = false;
-    } else {
-        json_vb["ongoing"] = true;
-        LOG_TRACE() << "json_game_state_for_user: before public_state_";
-        json_vb["public"] = public_state_();
-
-        LOG_TRACE() << "json_game_state_for_user: before private_state_";
-        json_vb["private"] = private_state_(user_id);
-    }
-
-    LOG_TRACE() << "json_game_state_for_user: before ToStableString";
-    std::string result = formats::json::ToStableString(json_vb.ExtractValue());
-
-    LOG_DEBUG() << "json_game_state_for_user: done";
+std::string
+GameRoom::json_game_state_for_user(const u_int64_t user_id,
+                                   const std::uint64_t known_version) const {
+    std::string result = state_message_(*snapshot_.Read(), Protocol::json,
+                                        user_id, known_version);
     LOG_TRACE() << "json_for_user: " << result;
     return result;
 }
 
-formats::json::Value GameRoom::public_state_() {
-    LOG_TRACE() << "public_state_: before get_game_state";
-    GameState state = game_.get_game_state();
-    LOG_TRACE() << "public_state_: after get_game_state, players="
-                << state.players.size()
-                << " playersState=" << state.playersState.size();
-
-    formats::json::ValueBuilder json_vb;
-
-    json_vb["current_player"] = state.current_player;
-    json_vb["bag_size"] = state.bag.size();
-
-    // players: id + score per player, index matches current_player
-    json_vb["players"].Resize(state.players.size());
-    for (size_t i = 0; i < state.players.size(); ++i) {
-        json_vb["players"][i]["id"] = state.players[i];
-        json_vb["players"][i]["score"] = state.playersState[i].score;
-    }
-    LOG_TRACE() << "public_state_: after players";
-
-    // letters
-    LOG_TRACE() << "public_state_: board_letters.size()="
-                << state.board_letters.size() << " row0.size()="
-                << (state.board_letters.empty()
-                        ? -1
-                        : (int)state.board_letters[0].size());
-    json_vb["letters"].Resize(state.board_letters.size());
-    for (size_t x = 0; x < state.board_letters.size(); ++x) {
-        json_vb["letters"][x].Resize(state.board_letters[x].size());
-        for (size_t y = 0; y < state.board_letters[x].size(); ++y) {
-            std::string cell;
-            if (state.board_letters[x][y]) {
-                cell = Char32ToUtf8(*state.board_letters[x][y]);
-            } else {
-                cell = " "; // пустая клетка
-            }
-            json_vb["letters"][x][y] = cell;
-        }
-        LOG_TRACE() << "public_state_: letters row x=" << x << " done";
-    }
-    LOG_TRACE() << "public_state_: after letters";
-
-    // prices
-    json_vb["prices"].Resize(state.board_prices.size());
-    for (size_t x = 0; x < state.board_prices.size(); ++x) {
-        json_vb["prices"][x].Resize(state.board_prices[x].size());
-        for (size_t y = 0; y < state.board_prices[x].size(); ++y) {
-            json_vb["prices"][x][y] = state.board_prices[x][y];
-        }
-    }
-    LOG_TRACE() << "public_state_: done";
-
-    return json_vb.ExtractValue();
+std::string
+GameRoom::binary_game_state_for_user(const u_int64_t user_id,
+                                     const std::uint64_t known_version) const {
+    return state_message_(*snapshot_.Read(), Protocol::binary, user_id,
+                          known_version);
 }
 
-formats::json::Value GameRoom::private_state_(const u_int64_t user_id) {
-    formats::json::ValueBuilder json_vb;
-    LOG_TRACE() << "private_state_: before get_player_hand";
-    const std::vector<char32_t> hand = game_.get_player_hand(user_id);
-    LOG_TRACE() << "private_state_: after get_player_hand, hand.size()="
-                << hand.size();
-    json_vb["hand"].Resize(hand.size());
-    for (size_t i = 0; i < hand.size(); ++i) {
-        json_vb["hand"][i] = Char32ToUtf8(hand[i]);
+std::string GameRoom::state_message_(const GameSnapshot &snapshot,
+                                     const Protocol protocol,
+                                     const u_int64_t user_id,
+                                     const std::uint64_t known_version) {
+    if (protocol == Protocol::binary) {
+        // flags, cells and scores of a delta without changes
+        static constexpr std::string_view kUnchanged{"\0\0\0", 3};
+        return StateForUser(snapshot, snapshot.binary, user_id, known_version,
+                            kUnchanged, &BinaryProtocol::StateMessage,
+                            &BinaryProtocol::DeltaMessage);
     }
-    LOG_TRACE() << "private_state_: before whose_move_id";
-    if (game_.whose_move_id() == static_cast<int64_t>(user_id))
-        json_vb["pending_score"] = game_.get_pending_score();
-    LOG_TRACE() << "private_state_: done";
-    return json_vb.ExtractValue();
+    return StateForUser(snapshot, snapshot.json, user_id, known_version, "{}",
+                        &ViewBuilder::state_message,
+                        &ViewBuilder::delta_message);
 }
 
-void GameRoom::action_place_(const formats::json::Value &json_msg,
+void GameRoom::action_place_(const PlayerCommand &command,
                              const int user_id) {
     if (!check_if_users_move_(user_id)) {
         sessions_[user_id]->send_raw_message(R"({"error":"Not your move"})");
         return;
     }
-    std::vector<std::vector<int>> coordinates =
-        json_msg["coordinates"].As<std::vector<std::vector<int>>>();
-    std::string letters = json_msg["letters"].As<std::string>();
-    std::vector<char32_t> tiles = utf8str_to_utf32vec_(letters);
-
     // TryPlaceTiles never throws: "" means the placement is valid, otherwise
     // the string is the reason to report to the player.
+    std::vector<std::vector<int>> coordinates = command.coordinates;
+    std::vector<Letter> tiles = command.tiles;
     std::string err =
         game_.TryPlaceTiles(std::move(coordinates), std::move(tiles));
     if (!err.empty()) {
@@ -209,10 +429,11 @@ void GameRoom::action_place_(const formats::json::Value &json_msg,
             formats::json::ToStableString(vb.ExtractValue()));
         return;
     }
+    publish_snapshot_();
     send_new_states();
 }
 
-void GameRoom::action_submit_(const formats::json::Value &json_msg,
+void GameRoom::action_submit_(const PlayerCommand &command,
                               const int user_id) {
 
     if (!check_if_users_move_(user_id)) {
@@ -225,37 +446,110 @@ void GameRoom::action_submit_(const formats::json::Value &json_msg,
             R"({"error":"Invalid placement"})");
         return;
     }
+    publish_snapshot_();
     send_new_states();
 }
 
-void GameRoom::action_change_(const formats::json::Value &json_msg,
+void GameRoom::action_change_(const PlayerCommand &command,
                               const int user_id) {
-    std::string tiles_utf8 = json_msg["tiles"].As<std::string>();
-    std::vector<char32_t> tiles = utf8str_to_utf32vec_(tiles_utf8);
-
-    if (!game_.Change(user_id, std::move(tiles))) {
+    if (!game_.Change(user_id, command.tiles)) {
         sessions_[user_id]->send_raw_message(R"({"error":"Invalid tiles"})");
         return;
     }
+    publish_snapshot_();
     send_new_states();
 }
-void GameRoom::action_end_(const formats::json::Value &json_msg,
+void GameRoom::action_end_(const PlayerCommand &command,
                            const int user_id) {
     return;
 }
-void GameRoom::action_pass_(const formats::json::Value &json_msg,
+void GameRoom::action_pass_(const PlayerCommand &command,
                             const int user_id) {
     if (!check_if_users_move_(user_id)) {
         sessions_[user_id]->send_raw_message(R"({"error":"Not your move"})");
         return;
     }
     game_.Pass();
+    publish_snapshot_();
+    send_new_states();
+}
+
+void GameRoom::action_takeback_(const PlayerCommand &command,
+                                const int user_id) {
+    const int64_t host_id = game_.get_game_state().players.front();
+    if (user_id == host_id && command.approve) {
+        if (!takeback_requester_) {
+            sessions_[user_id]->send_raw_message(
+                R"({"error":"No takeback request"})");
+            return;
+        }
+        const int64_t requester = *std::exchange(takeback_requester_, {});
+        if (!*command.approve) {
+            sessions_[requester]->send_raw_message(
+                R"({"takeback":"declined"})");
+            return;
+        }
+        if (!take_back_(requester))
+            sessions_[requester]->send_raw_message(
+                R"({"error":"Nothing to take back"})");
+        return;
+    }
+
+    if (game_.undo_depth(game_.check_if_player_joined(user_id)) == -1) {
+        sessions_[user_id]->send_raw_message(
+            R"({"error":"Nothing to take back"})");
+        return;
+    }
+    if (user_id == host_id) {
+        take_back_(user_id);
+        return;
+    }
+    takeback_requester_ = user_id;
+    formats::json::ValueBuilder vb;
+    vb["takeback_request"] = user_id;
+    sessions_[host_id]->send_raw_message(
+        formats::json::ToStableString(vb.ExtractValue()));
+}
+
+bool GameRoom::take_back_(const int64_t user_id) {
+    const int depth =
+        game_.undo_depth(game_.check_if_player_joined(user_id));
+    if (depth == -1)
+        return false;
+    for (int i = 0; i < depth; ++i)
+        game_.Undo();
+    publish_snapshot_();
     send_new_states();
+    return true;
 }
 
-void GameRoom::game_state_for_user_(const formats::json::Value &json_msg,
+void GameRoom::action_hint_(const PlayerCommand &command,
+                            const int user_id) {
+    const int limit =
+        std::clamp(command.limit.value_or(kHintsMax), 0, kHintsMax);
+    // game_mutex_ is held, the search must not stall the other actions
+    const std::vector<Move> moves = game_.Hint(
+        user_id, limit, std::chrono::steady_clock::now() + hint_budget_);
+
+    // hints go to the asking player only, like an error
+    formats::json::ValueBuilder vb;
+    vb["hints"].Resize(moves.size());
+    for (size_t i = 0; i < moves.size(); ++i) {
+        vb["hints"][i]["coordinates"] = moves[i].coordinates();
+        std::string letters;
+        for (const Letter tile : moves[i].tiles())
+            letters += LetterToUtf8(game_.alphabet(), tile);
+        vb["hints"][i]["letters"] = letters;
+        vb["hints"][i]["score"] = moves[i].score;
+    }
+    sessions_[user_id]->send_raw_message(
+        formats::json::ToStableString(vb.ExtractValue()));
+}
+
+void GameRoom::game_state_for_user_(const PlayerCommand &command,
                                     const int user_id) {
-    sessions_[user_id]->send_raw_message(json_game_state_for_user(user_id));
+    // a client sends the version it has to get only the changes since it
+    send_state_(*sessions_[user_id], user_id, command.version);
 }
 
 void GameRoom::close_session(const u_int64_t user_id) {
@@ -271,6 +565,10 @@ void GameRoom::close_session(const u_int64_t user_id) {
     // (close all).
     open_ = false;
     ongoing_ = false;
+    {
+        std::unique_lock<userver::engine::Mutex> lock(game_mutex_);
+        publish_snapshot_();
+    }
     std::shared_lock<userver::engine::SharedMutex> lock(mutex_);
     for (auto &[id, session] : sessions_)
         session->Close();
@@ -281,17 +579,22 @@ bool GameRoom::ongoing() const { return ongoing_; }
 bool GameRoom::session_open() const { return open_; }
 
 void GameRoom::set_players() {
-    std::unique_lock<userver::engine::SharedMutex> lock(mutex_);
-    // players_ is the authoritative membership list (the same one
-    // check_for_user validates against), so derive the game's player list
-    // from it instead of a separate query to keep the two in sync.
-    std::vector<int64_t> players(players_.begin(), players_.end());
+    std::vector<int64_t> players;
+    {
+        std::unique_lock<userver::engine::SharedMutex> lock(mutex_);
+        // players_ is the authoritative membership list (the same one
+        // check_for_user validates against), so derive the game's player
+        // list from it instead of a separate query to keep the two in sync.
+        players = players_;
+    }
+    // mutex_ is released first: moves take game_mutex_, then mutex_
+    std::unique_lock<userver::engine::Mutex> lock(game_mutex_);
     game_.set_players(std::move(players));
 }
 
 u_int64_t GameRoom::game_id() const { return game_id_; }
 
-int GameRoom::check_for_user(const u_int64_t user_id) const {
+int GameRoom::check_for_user(const int64_t user_id) const {
     auto iter = std::ranges::find(players_, user_id);
     if (iter == players_.end())
         return -1;
@@ -308,6 +611,9 @@ bool GameRoom::start() {
     if ((int)players_.size() != game_.get_players_max())
         return false;
     ongoing_ = true;
+    std::unique_lock<userver::engine::Mutex> lock(game_mutex_);
+    publish_snapshot_();
+    schedule_bots_();
     return true;
 }
 
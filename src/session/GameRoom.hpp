@@ -1,14 +1,58 @@
+#pragma once
+
+#include "game/GameViewBuilder.hpp"
 #include "game/Player.hpp"
+#include "session/BinaryProtocol.hpp"
 #include "game/ScrabbleGame.hpp"
 #include "session/PlayerSession.hpp"
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <optional>
+#include <string>
 #include <userver/engine/mutex.hpp>
 #include <userver/engine/shared_mutex.hpp>
+#include <userver/formats/json.hpp>
+#include <userver/rcu/rcu.hpp>
 
 namespace ScrabbleGame {
 
+/*
+ * @brief a state serialized in one protocol, see ViewBuilder and
+ * BinaryProtocol
+ */
+struct SerializedState {
+    // setup message of the game, shared by the snapshots of one game as it
+    // never changes
+    std::shared_ptr<const std::string> setup;
+    // part of the state every player gets
+    std::string public_state;
+    // part of the state only the player gets, by player id
+    std::map<int64_t, std::string> private_states;
+    // changes since version - 1 if GameSnapshot::has_delta
+    std::string public_delta;
+    // by player id, empty if nothing private of the player changed
+    std::map<int64_t, std::string> private_deltas;
+};
+
+/*
+ * @brief state of a room as of one committed change, never modified after
+ * it is published
+ */
+struct GameSnapshot {
+    // grows by one with every published snapshot of a room
+    std::uint64_t version = 0;
+    bool ongoing = false;
+    // what players saw of the game, to diff the next snapshot with it
+    GameView view;
+    // whether the deltas are from the snapshot of version - 1
+    bool has_delta = false;
+    SerializedState json;
+    SerializedState binary;
+};
+
 /*
  * Should store info about players of game, their status ??(connected, offline,
  * afk)?
@@ -18,24 +62,73 @@ namespace ScrabbleGame {
  * - if game is ongoing
  */
 
-class GameRoom {
+class BotClient;
+struct BotSettings;
+
+class GameRoom : public std::enable_shared_from_this<GameRoom> {
   public:
-    GameRoom(const u_int64_t game_id, ScrabbleGame &&game);
+    /*
+     * @param {hint_budget} time one hint action may search, the room waits
+     * for it
+     */
+    GameRoom(const u_int64_t game_id, ScrabbleGame &&game,
+             const std::chrono::milliseconds hint_budget);
     void attach_session(const u_int64_t user_id,
                         std::shared_ptr<PlayerSession> session);
 
-    const std::string wait_for_message(const u_int64_t user_id);
+    /*
+     * @brief takes a seat for a bot, it moves whenever its turn comes
+     *
+     * @param {bot_id} negative, so it never matches a user id
+     * @param {bots} plays the turns of bots, see BotClient
+     */
+    void attach_bot(const int64_t bot_id, std::shared_ptr<BotClient> bots);
+
+    /*
+     * @brief bots take seats with negative ids
+     */
+    static bool is_bot(const int64_t player_id) { return player_id < 0; }
+
+    /*
+     * @brief plays bot turns until a human has to move or the game is over
+     *
+     * @note runs on the bot task processor, see BotClient::Schedule
+     */
+    void play_bots(const BotSettings &settings);
+
+    OutgoingMessage wait_for_message(const u_int64_t user_id);
+
+    /*
+     * @brief pushes the last snapshot to every session that was sent an
+     * older one, as a delta from the version the session was sent last, or
+     * as a full state if it missed more than one
+     * @note game_mutex_ must be held since the publish, so no other snapshot
+     * is published in between and every version gets pushed
+     */
     void send_new_states();
 
     void receive_message(const int user_id, const std::string &msg);
 
+    /*
+     * @brief same as receive_message for a frame of Protocol::binary
+     */
+    void receive_binary_message(const int user_id, const std::string &msg);
+
+    /*
+     * @brief format of the frames sent to user_id from now on
+     *
+     * @note the first binary session of an ongoing game publishes a snapshot
+     * with the binary parts before it returns, see binary_
+     */
+    void set_protocol(const u_int64_t user_id, const Protocol protocol);
+
     u_int64_t game_id() const;
 
     /*
      * Checks for user existence in vector players_
      * @returns {index} in players_ or {-1} if player is not in game
      */
-    int check_for_user(const u_int64_t user_id) const;
+    int check_for_user(const int64_t user_id) const;
 
     /*
      * @brief registers this room's players_ (the single source of truth,
@@ -65,7 +158,24 @@ class GameRoom {
 
     void close_session(const u_int64_t user_id);
 
-    std::string json_game_state_for_user(const u_int64_t user_id);
+    /*
+     * @brief state of the game for user_id as of the last published
+     * snapshot
+     *
+     * @param {known_version} version the user already has, if it is the
+     * snapshot or the one before it only the delta is returned
+     * @note takes no lock of the room, so it never waits for a move
+     */
+    std::string
+    json_game_state_for_user(const u_int64_t user_id,
+                             const std::uint64_t known_version = 0) const;
+
+    /*
+     * @brief same as json_game_state_for_user in Protocol::binary
+     */
+    std::string
+    binary_game_state_for_user(const u_int64_t user_id,
+                               const std::uint64_t known_version = 0) const;
 
   private:
     const u_int64_t game_id_;
@@ -76,44 +186,106 @@ class GameRoom {
     // open_ is true from the initialization
     std::atomic<bool> open_;
     /*
-     * @brief Vector with user_ids of players
+     * @brief Vector with user_ids of players, bots have negative ids
      * @note [0] is the admin of game
      */
-    std::vector<u_int64_t> players_;
+    std::vector<int64_t> players_;
     std::map<u_int64_t, std::shared_ptr<PlayerSession>> sessions_;
     userver::engine::SharedMutex mutex_;
+    // serializes moves of players and bots on game_
+    userver::engine::Mutex game_mutex_;
+    // set if the room has bot seats
+    std::shared_ptr<BotClient> bots_;
+    // state after the last change of game_, read without locks
+    rcu::Variable<GameSnapshot> snapshot_;
+    // version of the last published snapshot, guarded by game_mutex_
+    std::uint64_t version_ = 0;
+    // a session uses Protocol::binary, snapshots get the binary parts from
+    // then on
+    std::atomic<bool> binary_ = false;
+    // player waiting for the host to allow a takeback, guarded by
+    // game_mutex_
+    std::optional<int64_t> takeback_requester_;
 
-    enum class PlayerAction {
-        // try to place tiles on board
-        place,
-        // change tiles in hand
-        change,
-        // pass the move
-        pass,
-        // try to submit tiles placed on board
-        submit,
-        // end a game
-        end,
-        // try to receive cur game_state in json
-        state
-    };
+    // max number of moves one hint message returns
+    static constexpr int kHintsMax = 20;
+    // time one hint action may search, see BotSettings::hint_budget
+    const std::chrono::milliseconds hint_budget_;
 
     bool check_if_users_move_(const int user_id);
 
+    /*
+     * @brief hands the turn to BotClient if a bot has to move
+     * @note game_mutex_ must be held
+     */
+    void schedule_bots_();
+
+    /*
+     * @brief plays the best move found in the move budget, exchanges the
+     * whole hand if there is none, passes if the bag is too small for that
+     * @note once the bag is empty the best move of a two-player game is the
+     * one of EndgameSolver
+     * @note game_mutex_ must be held
+     */
+    void play_bot_move_(const int64_t bot_id, const BotSettings &settings);
+
     PlayerAction from_string(const std::string &str);
 
-    void action_place_(const formats::json::Value &json_msg, const int user_id);
-    void action_change_(const formats::json::Value &json_msg,
-                        const int user_id);
-    void action_end_(const formats::json::Value &json_msg, const int user_id);
-    void action_pass_(const formats::json::Value &json_msg, const int user_id);
-    void action_submit_(const formats::json::Value &json_msg,
-                        const int user_id);
-    void game_state_for_user_(const formats::json::Value &json_msg,
+    /*
+     * @brief command of a json message, letters are read with the alphabet
+     * of the game
+     */
+    PlayerCommand command_from_json_(const formats::json::Value &json_msg);
+
+    /*
+     * @brief runs a command of user_id, whatever protocol it came in
+     */
+    void execute_(const PlayerCommand &command, const int user_id);
+
+    /*
+     * @brief state of snapshot for user_id in protocol, see
+     * json_game_state_for_user
+     */
+    static std::string state_message_(const GameSnapshot &snapshot,
+                                      const Protocol protocol,
+                                      const u_int64_t user_id,
+                                      const std::uint64_t known_version);
+
+    /*
+     * @brief state of the last snapshot in the protocol of the session,
+     * after the setup message if it is a full state; the session remembers
+     * its version
+     */
+    void send_state_(PlayerSession &session, const u_int64_t user_id,
+                     const std::uint64_t known_version) const;
+
+    void action_place_(const PlayerCommand &command, const int user_id);
+    void action_change_(const PlayerCommand &command, const int user_id);
+    void action_end_(const PlayerCommand &command, const int user_id);
+    void action_pass_(const PlayerCommand &command, const int user_id);
+    void action_submit_(const PlayerCommand &command, const int user_id);
+    void action_hint_(const PlayerCommand &command, const int user_id);
+
+    /*
+     * @brief the host takes back its last move at once, other players ask
+     * the host, who answers with "approve"
+     * @note moves made after the taken back one are taken back too
+     */
+    void action_takeback_(const PlayerCommand &command, const int user_id);
+
+    /*
+     * @brief reverts the last move of user_id and the moves after it
+     * @retval {false} user_id has no move to revert
+     */
+    bool take_back_(const int64_t user_id);
+    void game_state_for_user_(const PlayerCommand &command,
                               const int user_id);
 
-    formats::json::Value public_state_();
-    formats::json::Value private_state_(const u_int64_t user_id);
+    /*
+     * @brief publishes the state of game_ as a new snapshot
+     * @note game_mutex_ must be held
+     */
+    void publish_snapshot_();
 };
 
 } // namespace ScrabbleGame
@@ -4,19 +4,25 @@ namespace ScrabbleGame {
 
 void PlayerSession::send_raw_message(const std::string &msg) {
     std::unique_lock<engine::Mutex> lock(mutex_);
-    send_queue_.push(msg);
+    send_queue_.push({msg, true});
     cv_.NotifyOne();
     return;
 }
 
-const std::string PlayerSession::pop_wait() {
+void PlayerSession::send_binary_message(std::string msg) {
+    std::unique_lock<engine::Mutex> lock(mutex_);
+    send_queue_.push({std::move(msg), false});
+    cv_.NotifyOne();
+}
+
+OutgoingMessage PlayerSession::pop_wait() {
     std::unique_lock<engine::Mutex> lock(mutex_);
     bool res = cv_.Wait(lock, [&] { return closed_ or !send_queue_.empty(); });
     // Wait() can return early (task cancellation) before the predicate
     // actually holds, so re-check instead of assuming it does.
     if (closed_ || send_queue_.empty())
-        return "";
-    const std::string msg = send_queue_.front();
+        return {};
+    OutgoingMessage msg = std::move(send_queue_.front());
     send_queue_.pop();
     return msg;
 }
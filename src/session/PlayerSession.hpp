@@ -1,3 +1,8 @@
+#pragma once
+
+#include "session/BinaryProtocol.hpp"
+#include <atomic>
+#include <cstdint>
 #include <queue>
 #include <string>
 #include <userver/engine/condition_variable.hpp>
@@ -7,6 +12,15 @@ namespace ScrabbleGame {
 
 using namespace userver;
 
+/*
+ * @brief frame to send to a client
+ */
+struct OutgoingMessage {
+    std::string data;
+    // json frames are text, frames of Protocol::binary are binary
+    bool is_text = true;
+};
+
 /*
  * Represents relation between 1 person tand GameSession
  * Manages:
@@ -17,15 +31,26 @@ using namespace userver;
  */
 class PlayerSession {
   private:
-    std::queue<std::string> send_queue_;
+    std::queue<OutgoingMessage> send_queue_;
     engine::Mutex mutex_;
     engine::ConditionVariable cv_;
 
     bool closed_{false};
+    // set by the first message of the connection
+    std::atomic<Protocol> protocol_{Protocol::json};
+    // version of the last state sent, 0 before the first one
+    std::atomic<std::uint64_t> version_{0};
 
   public:
     void send_raw_message(const std::string &msg);
-    const std::string pop_wait();
+    void send_binary_message(std::string msg);
+    OutgoingMessage pop_wait();
+
+    Protocol protocol() const { return protocol_; }
+    void set_protocol(const Protocol protocol) { protocol_ = protocol; }
+
+    std::uint64_t version() const { return version_; }
+    void set_version(const std::uint64_t version) { version_ = version; }
 
     void Close();
 
@@ -1,3 +1,4 @@
+#include "game/Alphabet.hpp"
 #include "utfcpp/source/utf8.h"
 #include <string>
 #include <vector>
@@ -15,3 +16,21 @@ inline std::vector<char32_t> utf8str_to_utf32vec_(std::string &utf8str) {
     utf8::utf8to32(utf8str.begin(), utf8str.end(), std::back_inserter(tiles));
     return tiles;
 }
+
+inline std::string LetterToUtf8(const ScrabbleGame::Alphabet &alphabet,
+                                const ScrabbleGame::Letter letter) {
+    return std::string(alphabet.utf8(letter));
+}
+
+/*
+ * @brief converts letters received from a client to engine letter codes
+ * @notes characters outside of alphabet become kInvalidLetter
+ */
+inline std::vector<ScrabbleGame::Letter>
+utf8str_to_letters_(const ScrabbleGame::Alphabet &alphabet,
+                    std::string &utf8str) {
+    std::vector<ScrabbleGame::Letter> letters;
+    for (const char32_t c : utf8str_to_utf32vec_(utf8str))
+        letters.push_back(alphabet.encode(c));
+    return letters;
+}
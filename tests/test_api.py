@@ -1,4 +1,7 @@
+import contextlib
 import json
+import zlib
+
 import pytest
 
 
@@ -25,6 +28,21 @@ async def token(service_client):
     return resp.text
 
 
+@pytest.fixture
+async def token2(service_client):
+    await service_client.post('/reg', json={
+        'email': 'testuser2@example.com',
+        'passwd': PASSWD,
+        'nick': NICK2,
+    })
+    resp = await service_client.post('/login', json={
+        'login': NICK2,
+        'passwd': PASSWD,
+    })
+    assert resp.status == 200
+    return resp.text
+
+
 @pytest.fixture
 async def game_id(service_client, token):
     resp = await service_client.post('/game', json={
@@ -35,6 +53,57 @@ async def game_id(service_client, token):
     return int(resp.text)
 
 
+async def create_bot_game(service_client, token, **options):
+    # a lone host starts a game against a bot seat, the host moves first
+    resp = await service_client.post('/game', json={
+        'token': token,
+        'action': 'create',
+        'bots': 1,
+        **options,
+    })
+    assert resp.status == 200
+    game_id = int(resp.text)
+
+    resp = await service_client.post('/game', json={
+        'token': token,
+        'action': 'start',
+        'game_id': game_id,
+    })
+    assert resp.status == 200
+    return game_id
+
+
+@pytest.fixture
+async def bot_game_id(service_client, token):
+    return await create_bot_game(service_client, token)
+
+
+@contextlib.asynccontextmanager
+async def game_socket(websocket_client, token, game_id, **handshake):
+    async with websocket_client.get('ws') as ws:
+        await ws.send(json.dumps({
+            'token': token,
+            'game_id': game_id,
+            **handshake,
+        }))
+        yield ws
+
+
+async def recv_message(ws):
+    # deltas of moves made meanwhile, by a bot, may come before the answer
+    while True:
+        data = json.loads(await ws.recv())
+        if 'base' not in data:
+            return data
+
+
+async def recv_full_state(ws, **request):
+    # a full state always comes after the setup of the game
+    await ws.send(json.dumps({'action': 'state', **request}))
+    setup = (await recv_message(ws))['setup']
+    return setup, await recv_message(ws)
+
+
 async def test_register(service_client):
     resp = await service_client.post('/reg', json={
         'email': 'new@example.com',
@@ -72,7 +141,8 @@ async def test_create_and_join_game(service_client, token, game_id):
     assert int(resp.text) == game_id
 
 
-async def test_websocket_auth(service_client, websocket_client, token, game_id):
+async def test_websocket_auth(service_client, websocket_client, token,
+                              token2, game_id):
     # join
     await service_client.post('/game', json={
         'token': token,
@@ -80,26 +150,63 @@ async def test_websocket_auth(service_client, websocket_client, token, game_id):
         'game_id': game_id,
     })
 
-    # second player registers and joins (game needs 2 players to start)
-    await service_client.post('/reg', json={
-        'email': 'testuser2@example.com',
-        'passwd': PASSWD,
-        'nick': NICK2,
+    # second player joins (game needs 2 players to start)
+    resp = await service_client.post('/game', json={
+        'token': token2,
+        'action': 'join',
+        'game_id': game_id,
     })
-    resp = await service_client.post('/login', json={
-        'login':  NICK2,
-        'passwd': PASSWD,
+    assert resp.status == 200
+
+    resp = await service_client.post('/game', json={
+        'token': token,
+        'action': 'start',
+        'game_id': game_id,
+    })
+    assert resp.status == 200
+
+    async with game_socket(websocket_client, token, game_id) as ws:
+        _, data = await recv_full_state(ws)
+        assert 'public' in data
+        assert 'private' in data
+        assert 'hand' in data['private']
+
+
+async def test_game_with_bot(websocket_client, token, bot_game_id):
+    async with game_socket(websocket_client, token, bot_game_id) as ws:
+        setup, data = await recv_full_state(ws)
+        assert data['ongoing']
+        assert len(setup['players']) == 2
+        assert setup['players'][1] < 0
+        assert len(data['public']['scores']) == 2
+
+
+async def test_bots_with_humans(service_client, websocket_client, token,
+                                token2):
+    resp = await service_client.post('/game', json={
+        'token': token,
+        'action': 'create',
+        'players': 3,
+        'bots': 2,
+    })
+    assert resp.status == 400
+
+    resp = await service_client.post('/game', json={
+        'token': token,
+        'action': 'create',
+        'players': 2,
+        'bots': 1,
     })
     assert resp.status == 200
-    token2 = resp.text
+    game_id = int(resp.text)
 
+    # the bot takes only the extra seat, the second human joins
     resp = await service_client.post('/game', json={
         'token': token2,
         'action': 'join',
         'game_id': game_id,
     })
     assert resp.status == 200
-
     resp = await service_client.post('/game', json={
         'token': token,
         'action': 'start',
@@ -107,17 +214,125 @@ async def test_websocket_auth(service_client, websocket_client, token, game_id):
     })
     assert resp.status == 200
 
-    async with websocket_client.get('ws') as ws:
-        # first message - auth
-        await ws.send(json.dumps({
-            'token': token,
-            'game_id': game_id,
-        }))
+    async with game_socket(websocket_client, token, game_id) as ws:
+        setup, data = await recv_full_state(ws)
+        assert data['ongoing']
+        assert len(setup['players']) == 3
+        assert len([id for id in setup['players'] if id < 0]) == 1
 
+
+async def test_state_version_grows(websocket_client, token, bot_game_id):
+    async with game_socket(websocket_client, token, bot_game_id) as ws:
+        _, before = await recv_full_state(ws)
+
+        # passing publishes a new snapshot
+        await ws.send(json.dumps({'action': 'pass'}))
+        after = json.loads(await ws.recv())['version']
+        assert after > before['version']
+
+
+async def test_state_delta(websocket_client, token, bot_game_id):
+    async with game_socket(websocket_client, token, bot_game_id) as ws:
+        _, before = await recv_full_state(ws)
+        assert 'base' not in before
+        assert 'prices' not in before['public']
+
+        # the pass is pushed as a delta from the version we have
+        await ws.send(json.dumps({'action': 'pass'}))
+        delta = json.loads(await ws.recv())
+        assert delta['base'] == before['version']
+        assert delta['version'] == before['version'] + 1
+        assert delta['public']['current_player'] == 1
+        assert 'letters' not in delta['public']
+        assert 'pending_score' not in delta.get('private', {})
+
+        # a client that missed versions gets the setup and the full state
+        _, data = await recv_full_state(ws, version=0)
+        assert 'base' not in data
+        assert 'letters' in data['public']
+
+
+async def test_takeback(websocket_client, token, bot_game_id):
+    async with game_socket(websocket_client, token, bot_game_id) as ws:
+        _, before = await recv_full_state(ws)
+
+        await ws.send(json.dumps({'action': 'pass'}))
+        passed = json.loads(await ws.recv())['version']
+
+        # the host takes back the pass, and the bot reply if it came first
+        await ws.send(json.dumps({'action': 'takeback'}))
+        for _ in range(5):
+            _, data = await recv_full_state(ws)
+            if (data['version'] > passed
+                    and data['public'] == before['public']
+                    and data['private'] == before['private']):
+                break
+        else:
+            assert False, 'the game was not taken back'
+
+
+async def test_quick_variant(service_client, websocket_client, token):
+    resp = await service_client.post('/game', json={
+        'token': token,
+        'action': 'create',
+        'variant': 'nonexistent',
+    })
+    assert resp.status == 400
+
+    game_id = await create_bot_game(service_client, token, variant='quick')
+    async with game_socket(websocket_client, token, game_id) as ws:
+        setup, data = await recv_full_state(ws)
+        assert setup['variant'] == 'quick'
+        assert setup['width'] == 11 and setup['height'] == 11
+        assert len(setup['prices']) == 11
+        assert len(setup['alphabet']) == len(setup['values'])
+
+        letters = data['public']['letters']
+        assert len(letters) == 11
+        assert all(len(column) == 11 for column in letters)
+
+
+async def test_binary_protocol(websocket_client, token, bot_game_id):
+    async with game_socket(websocket_client, token, bot_game_id,
+                           protocol='binary') as ws:
+        # state: setup frame, variant, 15 x 15, then full state frame, host
+        # to move
+        await ws.send(bytes([6]))
+        frame = await ws.recv()
+        assert frame[0:4] == bytes([5, 0, 15, 15])
+        frame = await ws.recv()
+        assert frame[0] == 2
+        version = frame[1]
+        assert frame[2] == 0
+
+        # pass: delta frame from our version, the turn goes to the bot
+        await ws.send(bytes([3]))
+        frame = await ws.recv()
+        assert frame[0] == 3
+        assert frame[1] == version
+        assert frame[2] == version + 1
+        assert frame[3:5] == bytes([1, 1])
+
+
+async def test_deflate(websocket_client, token, bot_game_id):
+    async with game_socket(websocket_client, token, bot_game_id,
+                           compression='deflate') as ws:
+        # the setup and the full state are over the threshold, they come
+        # deflated with one context
         await ws.send(json.dumps({'action': 'state'}))
+        inflater = zlib.decompressobj(-zlib.MAX_WBITS)
+        messages = []
+        for _ in range(2):
+            frame = await ws.recv()
+            assert isinstance(frame, bytes)
+            assert frame[0] == 4
+            messages.append(json.loads(
+                inflater.decompress(frame[1:] + b'\x00\x00\xff\xff')))
+        setup, data = messages
+        assert 'prices' in setup['setup']
+        assert 'letters' in data['public']
 
-        msg = await ws.recv()
-        data = json.loads(msg)
-        assert 'public' in data
-        assert 'private' in data
-        assert 'hand' in data['private']
+        # a small delta is sent as it is
+        await ws.send(json.dumps({'action': 'pass'}))
+        delta = json.loads(await ws.recv())
+        assert delta['base'] == data['version']